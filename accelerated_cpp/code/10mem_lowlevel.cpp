@@ -1,5 +1,15 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <string_view>
+#include <unordered_set>
+
+#include "algo_simd.h"
 
 using namespace std;
 
@@ -12,6 +22,161 @@ template<class In, class Pred> In find_if(In begin, In end, Pred f){
 }
 
 
+// predicates find_if can see through
+// an arbitrary function or lambda is a black box, find_if has to call it
+// on every element. these say what they test, so on contiguous memory
+// find_if can test 16 bytes at a time and stop at the first vector with
+// a hit. they are still ordinary function objects everywhere else.
+
+// x == value
+template<class T> struct equal_to_value {
+  T value;
+  explicit equal_to_value(const T& v): value(v) { }
+  bool operator()(const T& x) const { return x == value; }
+};
+
+// lo <= x && x <= hi
+template<class T> struct in_range {
+  T lo, hi;
+  in_range(const T& l, const T& h): lo(l), hi(h) { }
+  bool operator()(const T& x) const { return lo <= x && x <= hi; }
+};
+
+// a set of chars given as a few ranges, optionally complemented:
+// enough for the <cctype> classes in the "C" locale
+class char_class {
+public:
+  static const int max_ranges = 4;
+
+  char_class(): n(0), negate(false) { }
+  char_class& add(unsigned char lo, unsigned char hi){
+    if(n == max_ranges)
+      throw length_error("char_class has too many ranges");
+    lo_[n] = lo;
+    hi_[n] = hi;
+    ++n;
+    return *this;
+  }
+  char_class operator!() const {
+    char_class ret = *this;
+    ret.negate = !negate;
+    return ret;
+  }
+
+  bool operator()(char c) const {
+    unsigned char u = c;
+    bool hit = false;
+    for(int i = 0; i != n; ++i)
+      hit |= (unsigned char)(u - lo_[i]) <= (unsigned char)(hi_[i] - lo_[i]);
+    return hit != negate;
+  }
+
+  static char_class space() { return char_class().add('\t', '\r').add(' ', ' '); }
+  static char_class digit() { return char_class().add('0', '9'); }
+  static char_class alpha() { return char_class().add('A', 'Z').add('a', 'z'); }
+
+#ifdef __SSE2__
+  // one bit per byte of the 16 at p that is in the class
+  int match16(const char* p) const {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hit = _mm_setzero_si128();
+    for(int i = 0; i != n; ++i){
+      // lo <= c <= hi as the unsigned test c - lo <= hi - lo
+      __m128i d = _mm_sub_epi8(v, _mm_set1_epi8((char)lo_[i]));
+      __m128i w = _mm_set1_epi8((char)(hi_[i] - lo_[i]));
+      hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(d, w), d));
+    }
+    int m = _mm_movemask_epi8(hit);
+    return negate ? ~m & 0xFFFF : m;
+  }
+#endif
+
+private:
+  unsigned char lo_[max_ranges], hi_[max_ranges];
+  int n;
+  bool negate;
+};
+
+
+// the vector versions, picked over the generic find_if for pointer ranges
+// because they are more specialized
+
+template<class T> T* find_if(T* begin, T* end, const equal_to_value<typename remove_const<T>::type>& f){
+  typedef typename remove_const<T>::type U;
+  if constexpr (has_simd_lanes<U>::value)
+    return const_cast<T*>(simd_find<U>(begin, end, f.value));
+  else
+    return ::find_if<T*, equal_to_value<U> >(begin, end, f);
+}
+
+template<class T> T* find_if(T* begin, T* end, const in_range<typename remove_const<T>::type>& f){
+  typedef typename remove_const<T>::type U;
+#ifdef __SSE2__
+  if constexpr (is_integral<U>::value && (sizeof(U) == 1 || sizeof(U) == 4)){
+    if(f.hi < f.lo)
+      return end;
+    // same unsigned trick as char_class: x - lo <= hi - lo
+    typedef typename make_unsigned<U>::type W;
+    const W width = W(f.hi) - W(f.lo);
+    for(; end - begin >= 16 / (ptrdiff_t)sizeof(U); begin += 16 / sizeof(U)){
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+      int m;
+      if constexpr (sizeof(U) == 1){
+        __m128i d = _mm_sub_epi8(v, _mm_set1_epi8((char)f.lo));
+        __m128i w = _mm_set1_epi8((char)width);
+        m = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, w), d));
+      } else {
+        // no unsigned 32-bit compare in SSE2: flip the sign bits and
+        // compare signed, d > w is the miss
+        const __m128i bias = _mm_set1_epi32(int(0x80000000u));
+        __m128i d = _mm_xor_si128(_mm_sub_epi32(v, _mm_set1_epi32((int)f.lo)), bias);
+        __m128i w = _mm_xor_si128(_mm_set1_epi32((int)width), bias);
+        m = ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(d, w))) & 0xF;
+      }
+      if(m)
+        return begin + __builtin_ctz(m);
+    }
+  }
+#endif
+  return ::find_if<T*, in_range<U> >(begin, end, f);
+}
+
+template<class T> T* find_if(T* begin, T* end, const char_class& f){
+  static_assert(sizeof(T) == 1, "char_class is for ranges of char");
+#ifdef __SSE2__
+  for(; end - begin >= 16; begin += 16){
+    int m = f.match16(reinterpret_cast<const char*>(begin));
+    if(m)
+      return begin + __builtin_ctz(m);
+  }
+#endif
+  return ::find_if<T*, char_class>(begin, end, f);
+}
+
+
+// split, working on the string's characters in place
+vector<string> split(const string& str){
+  const char_class space = char_class::space(), not_space = !space;
+  vector<string> ret;
+
+  const char* i = str.data();
+  const char* end = i + str.size();
+  while(i != end){
+    // ignore leading blanks
+    i = ::find_if(i, end, not_space);
+
+    // find end of next word
+    const char* j = ::find_if(i, end, space);
+
+    // copy chars in [i, j)
+    if(i != end)
+      ret.push_back(string(i, j));
+    i = j;
+  }
+  return ret;
+}
+
+
 char* duplicate_chars(const char* p){
   // allocate space
   size_t length = strlen(p) + 1;
@@ -21,3 +186,170 @@ char* duplicate_chars(const char* p){
   copy(p, p + length, result);
   return result;
 }
+
+
+// duplicate_chars with the memory management taken off the caller:
+// copies are carved out of big blocks the arena owns, so making one is a
+// pointer bump and they all go away together when the arena is cleared
+// or destroyed. the pointers handed out don't own anything.
+class String_arena {
+public:
+  explicit String_arena(size_t block = 64 * 1024): block_size(block), next(0), limit(0) { }
+  ~String_arena() { release(); }
+
+  // null-terminated copy of p
+  const char* duplicate(const char* p) { return duplicate(p, strlen(p)); }
+  const char* duplicate(const char* p, size_t length){
+    char* result = allocate(length + 1);
+    memcpy(result, p, length);
+    result[length] = '\0';
+    return result;
+  }
+
+  // like duplicate, but equal strings share one copy, so interned
+  // strings can be compared by pointer
+  const char* intern(const char* p) { return intern(p, strlen(p)); }
+  const char* intern(const char* p, size_t length){
+    unordered_set<string_view>::const_iterator it = index.find(string_view(p, length));
+    if(it != index.end())
+      return it->data();
+    const char* copy = duplicate(p, length);
+    index.insert(string_view(copy, length));
+    return copy;
+  }
+
+  // every pointer handed out so far becomes invalid
+  void clear(){
+    release();
+    blocks.clear();
+    index.clear();
+    next = limit = 0;
+  }
+
+  size_t blocks_used() const { return blocks.size(); }
+
+private:
+  String_arena(const String_arena&);
+  String_arena& operator=(const String_arena&);
+
+  char* allocate(size_t n){
+    if(n > size_t(limit - next)){
+      // strings bigger than a block get a block of their own
+      size_t size = max(n, block_size);
+      blocks.push_back(new char[size]);
+      next = blocks.back();
+      limit = next + size;
+    }
+    char* ret = next;
+    next += n;
+    return ret;
+  }
+
+  void release(){
+    for(vector<char*>::size_type i = 0; i != blocks.size(); ++i)
+      delete[] blocks[i];
+  }
+
+  size_t block_size;
+  vector<char*> blocks;
+  char* next;
+  char* limit;
+  unordered_set<string_view> index;
+};
+
+
+// benchmark: the same searches with opaque predicates (plain functions the
+// generic find_if has to call) and with the predicate types above
+
+bool is_space(char c){ return isspace(c); }
+bool is_not_space(char c){ return !isspace(c); }
+
+// split from chapter 6
+vector<string> split_opaque(const string& str){
+  typedef string::const_iterator iter;
+  vector<string> ret;
+  iter i = str.begin();
+  while(i != str.end()){
+    i = ::find_if(i, str.end(), is_not_space);
+    iter j = ::find_if(i, str.end(), is_space);
+    if(i != str.end())
+      ret.push_back(string(i, j));
+    i = j;
+  }
+  return ret;
+}
+
+template<class F> double time_ms(F f, int reps = 10){
+  chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+  for(int r = 0; r != reps; ++r)
+    f();
+  chrono::duration<double, milli> d = chrono::steady_clock::now() - t0;
+  return d.count() / reps;
+}
+
+bool is_answer(int x){ return x == 42; }
+bool is_between(int x){ return 1000 <= x && x <= 2000; }
+
+int main(){
+  const size_t n = 1 << 22;
+  vector<int> v(n);
+  for(size_t i = 0; i != n; ++i)
+    v[i] = int(i % 997) + 3000;
+  v[n - 1] = 42;                  // the only hit is at the very end
+  v[n - 2] = 1500;
+  const int* b = &v[0];
+  const int* e = b + n;
+  size_t sink = 0;
+
+  double eq_opaque = time_ms([&]{ sink += ::find_if(b, e, is_answer) - b; });
+  double eq_simd = time_ms([&]{ sink += ::find_if(b, e, equal_to_value<int>(42)) - b; });
+  double rg_opaque = time_ms([&]{ sink += ::find_if(b, e, is_between) - b; });
+  double rg_simd = time_ms([&]{ sink += ::find_if(b, e, in_range<int>(1000, 2000)) - b; });
+
+  // long words with single spaces, the case where scanning dominates
+  string text;
+  for(size_t i = 0; text.size() < n; ++i)
+    text += string(20 + i % 40, 'a' + i % 26) + (i % 7 ? " " : "\n\t ");
+  double split_opaque_ms = time_ms([&]{ sink += split_opaque(text).size(); });
+  double split_simd_ms = time_ms([&]{ sink += split(text).size(); });
+
+  if(split(text) != split_opaque(text))
+    cout << "split versions disagree" << endl;
+
+  // a symbol table's worth of keys, many of them repeated
+  vector<string> keys(1 << 20);
+  for(size_t i = 0; i != keys.size(); ++i)
+    keys[i] = "section" + to_string(i % 64) + ".key" + to_string(i % 50000);
+  vector<const char*> copies(keys.size());
+
+  double dup_new = time_ms([&]{
+    for(size_t i = 0; i != keys.size(); ++i)
+      copies[i] = duplicate_chars(keys[i].c_str());
+    for(size_t i = 0; i != keys.size(); ++i)
+      delete[] copies[i];
+  });
+  double dup_arena = time_ms([&]{
+    String_arena arena;
+    for(size_t i = 0; i != keys.size(); ++i)
+      copies[i] = arena.duplicate(keys[i].data(), keys[i].size());
+  });
+  double dup_intern = time_ms([&]{
+    String_arena arena;
+    for(size_t i = 0; i != keys.size(); ++i)
+      copies[i] = arena.intern(keys[i].data(), keys[i].size());
+    sink += arena.blocks_used();
+  });
+
+  cout << "find_if over " << n << " ints (ms opaque / specialized)" << endl
+       << "  x == 42          " << eq_opaque << " / " << eq_simd << endl
+       << "  1000 <= x <= 2000 " << rg_opaque << " / " << rg_simd << endl
+       << "split " << text.size() << " chars" << endl
+       << "  isspace          " << split_opaque_ms << " / " << split_simd_ms << endl
+       << "copy and free " << keys.size() << " strings (ms)" << endl
+       << "  duplicate_chars  " << dup_new << endl
+       << "  arena            " << dup_arena << endl
+       << "  arena, interned  " << dup_intern << endl;
+  if(sink == 0)
+    cout << "";
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Core.h"
+#include "display_width.h"
+#include "grade_all.h"
+
+using namespace std;
+
+// input: one student per record, starting with U (undergraduate) or G (graduate)
+//   U name midterm final hw...
+//   G name midterm final thesis hw...
+int main()
+{
+    vector<Core *> students;
+    string::size_type maxlen = 0;
+    char ch;
+
+    while (cin >> ch)
+    {
+        Core *record = (ch == 'U') ? new Core(cin) : new Grad(cin);
+        maxlen = max(maxlen, display_width(record->name()));
+        students.push_back(record);
+    }
+
+    // sort by name
+    sort(students.begin(), students.end(), compare_Core_ptrs);
+
+    // grade everyone at once, grades[i] belongs to students[i]
+    vector<double> grades;
+    grade_all(students, grades);
+
+    // write names and grades
+    for (vector<Core *>::size_type i = 0; i != students.size(); ++i)
+    {
+        cout << students[i]->name()
+             << string(maxlen + 1 - display_width(students[i]->name()), ' ');
+        if (isnan(grades[i]))
+        {
+            cout << "student has done no homework";
+        }
+        else
+        {
+            streamsize prec = cout.precision();
+            cout << setprecision(3) << grades[i] << setprecision(prec);
+        }
+        cout << endl;
+        delete students[i];
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "roster_snapshot.h"
+
+using namespace std;
+
+// convert between the text roster format and binary snapshots
+//   13.2roster_snapshot pack  out.snap < roster.txt
+//   13.2roster_snapshot text  in.snap  > roster.txt
+//   13.2roster_snapshot grade in.snap
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        cerr << "usage: " << argv[0] << " pack|text|grade snapshot" << endl;
+        return 1;
+    }
+    string cmd = argv[1], path = argv[2];
+
+    try
+    {
+        if (cmd == "pack")
+        {
+            text_to_snapshot(cin, path);
+            return 0;
+        }
+
+        // opening is just an mmap, time it to show there is no parsing
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        Roster_snapshot snap(path);
+        chrono::duration<double, milli> ms = chrono::steady_clock::now() - t0;
+        cerr << "opened " << snap.size() << " students in " << ms.count() << " ms" << endl;
+
+        if (cmd == "text")
+        {
+            snapshot_to_text(cout, snap);
+        }
+        else if (cmd == "grade")
+        {
+            streamsize prec = cout.precision();
+            cout << setprecision(3);
+            for (Roster_snapshot::size_type i = 0; i != snap.size(); ++i)
+            {
+                cout << snap.name(i) << ' ';
+                try
+                {
+                    cout << grade(snap, i);
+                }
+                catch (const domain_error &e)
+                {
+                    cout << e.what();
+                }
+                cout << '\n';
+            }
+            cout << setprecision(prec);
+        }
+        else
+        {
+            cerr << "unknown command " << cmd << endl;
+            return 1;
+        }
+    }
+    catch (const runtime_error &e)
+    {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstdlib>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Core.h"
+#include "grade_all.h"
+#include "rank.h"
+
+using namespace std;
+
+// read a roster (same format as 13.1grade_all) and report only the top
+// students, the ones at or above a percentile, and a grade histogram
+//   13.3ranking [k] [percentile]
+int main(int argc, char **argv)
+{
+    // parsed signed, so that a negative k is caught rather than wrapping
+    // around to a huge rank_sz
+    long long n = argc > 1 ? atoll(argv[1]) : 10;
+    if (n < 0)
+    {
+        cerr << "usage: 13.3ranking [k] [percentile], k >= 0" << endl;
+        return 1;
+    }
+    rank_sz k = n;
+    double pct = argc > 2 ? atof(argv[2]) : 90;
+
+    vector<Core *> students;
+    char ch;
+    while (cin >> ch)
+        students.push_back(ch == 'U' ? new Core(cin) : new Grad(cin));
+
+    vector<double> grades;
+    grade_all(students, grades);
+
+    streamsize prec = cout.precision();
+    cout << setprecision(3);
+
+    cout << "top " << k << ":" << endl;
+    vector<rank_sz> best = top_k(grades, k);
+    for (vector<rank_sz>::size_type i = 0; i != best.size(); ++i)
+        cout << "  " << i + 1 << ". " << students[best[i]]->name() << " "
+             << grades[best[i]] << endl;
+
+    try
+    {
+        double cutoff = percentile(grades, pct);
+        vector<rank_sz> above = at_or_above(grades, cutoff);
+        cout << above.size() << " students at or above the " << pct
+             << "th percentile (" << cutoff << ")" << endl;
+    }
+    catch (const domain_error &e)
+    {
+        cout << e.what() << endl;
+    }
+
+    vector<rank_sz> counts = histogram(grades, 0, 100, 10);
+    for (rank_sz b = 0; b != counts.size(); ++b)
+        cout << setw(3) << b * 10 << "-" << setw(3) << left << (b + 1) * 10
+             << right << " " << counts[b] << endl;
+
+    cout << setprecision(prec);
+    for (vector<Core *>::size_type i = 0; i != students.size(); ++i)
+        delete students[i];
+    return 0;
+}
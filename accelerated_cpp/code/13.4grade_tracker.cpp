@@ -0,0 +1,60 @@
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "Core.h"
+#include "grade_tracker.h"
+
+using namespace std;
+
+// load a roster (same format as 13.1grade_all), then read a stream of
+// "name score" homework submissions from standard input and write each
+// student's updated grade as it comes in
+//   13.4grade_tracker roster.txt < submissions.txt
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        cerr << "usage: " << argv[0] << " roster" << endl;
+        return 1;
+    }
+
+    ifstream roster(argv[1]);
+    map<string, Grade_tracker> trackers;
+    char ch;
+    while (roster >> ch)
+    {
+        if (ch == 'U')
+        {
+            Core c(roster);
+            trackers[c.name()] = Grade_tracker(c);
+        }
+        else
+        {
+            Grad g(roster);
+            trackers[g.name()] = Grade_tracker(g);
+        }
+    }
+
+    streamsize prec = cout.precision();
+    cout << setprecision(3);
+
+    string name;
+    double score;
+    while (cin >> name >> score)
+    {
+        map<string, Grade_tracker>::iterator it = trackers.find(name);
+        if (it == trackers.end())
+        {
+            cout << name << " is not on the roster" << endl;
+            continue;
+        }
+        cout << name << " " << it->second.add_homework(score) << endl;
+    }
+
+    cout << setprecision(prec);
+    return 0;
+}
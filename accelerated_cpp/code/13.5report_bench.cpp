@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "report_format.h"
+
+using namespace std;
+
+// the report loop from chapter 4
+void write_report(ostream &os, const vector<string> &names,
+                  const vector<double> &grades, string::size_type maxlen)
+{
+    for (vector<string>::size_type i = 0; i != names.size(); ++i)
+    {
+        os << names[i] << string(maxlen + 1 - names[i].size(), ' ');
+        streamsize prec = os.precision();
+        os << setprecision(3) << grades[i] << setprecision(prec);
+        os << endl;
+    }
+}
+
+void write_report(Report_writer &w, const vector<string> &names,
+                  const vector<double> &grades)
+{
+    for (vector<string>::size_type i = 0; i != names.size(); ++i)
+        w.row(names[i], grades[i]);
+}
+
+// compare the chapter 4 report loop against Report_writer
+//   13.5report_bench [rows]
+int main(int argc, char **argv)
+{
+    vector<string>::size_type rows = argc > 1 ? atol(argv[1]) : 10000000;
+
+    mt19937 gen(42);
+    uniform_int_distribution<int> len(3, 20), letter('a', 'z');
+    uniform_real_distribution<double> g(0, 100);
+
+    vector<string> names(rows);
+    vector<double> grades(rows);
+    string::size_type maxlen = 0;
+    for (vector<string>::size_type i = 0; i != rows; ++i)
+    {
+        names[i].resize(len(gen));
+        for (string::size_type j = 0; j != names[i].size(); ++j)
+            names[i][j] = letter(gen);
+        grades[i] = g(gen);
+        maxlen = max(maxlen, names[i].size());
+    }
+
+    // both must write exactly the same bytes
+    vector<string> few(names.begin(), names.begin() + min<size_t>(rows, 1000));
+    ostringstream expect, got;
+    write_report(expect, few, grades, maxlen);
+    {
+        Report_writer w(got, maxlen);
+        write_report(w, few, grades);
+    }
+    if (expect.str() != got.str())
+    {
+        cerr << "outputs differ" << endl;
+        return 1;
+    }
+
+    // endl flushes every row, so write to a file nobody reads
+    ofstream null("/dev/null");
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    write_report(null, names, grades, maxlen);
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    {
+        Report_writer w(null, maxlen);
+        write_report(w, names, grades);
+    }
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+
+    chrono::duration<double> loop = t1 - t0, writer = t2 - t1;
+    cout << rows << " rows" << endl;
+    cout << "report loop:   " << loop.count() << " s, "
+         << loop.count() * 1e9 / rows << " ns/row" << endl;
+    cout << "Report_writer: " << writer.count() << " s, "
+         << writer.count() * 1e9 / rows << " ns/row" << endl;
+    return 0;
+}
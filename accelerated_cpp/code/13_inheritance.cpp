@@ -2,6 +2,8 @@
 #include <vector>
 #include <iostream>
 
+#include "display_width.h"
+
 class Core
 {
   public:
@@ -139,7 +141,7 @@ int main()
 
     while (record.read(std::cin))
     {
-        maxlen = std::max(maxlen, record.name().size());
+        maxlen = std::max(maxlen, display_width(record.name()));
         students.push_back(record);
     }
 
@@ -150,7 +152,7 @@ int main()
     for (std::vector<Core>::size_type i = 0; i != students.size(); ++i)
     {
         std::cout << students[i].name()
-                  << std::string(maxlen + 1 - students[i].name.size(), ' ');
+                  << std::string(maxlen + 1 - display_width(students[i].name()), ' ');
         try
         {
             double final_grade = students[i].grade(); // Core::grade()
@@ -0,0 +1,30 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Pic.h"
+
+using namespace std;
+
+int main()
+{
+    vector<string> v;
+    v.push_back("Hello, world!");
+    v.push_back("character");
+    v.push_back("pictures");
+
+    // none of these copy v again, or each other
+    Picture p = v;
+    Picture q = frame(p);
+    Picture r = hcat(p, q);
+    Picture s = vcat(q, r);
+    cout << frame(hcat(s, q)) << endl;
+
+    // deep nesting shares every level, the text is written once per row
+    Picture deep = p;
+    for (int i = 0; i != 5; ++i)
+        deep = frame(vcat(deep, p));
+    cout << deep;
+
+    return 0;
+}
@@ -19,26 +19,28 @@ int main(){
     // separaitng output from input 
     std::cout << std::endl;
 
-    // write row rows of output 
+    // build all rows of output in one buffer, a run of chars at a time,
+    // then write it with a single call
+    std::string out;
+    out.reserve(rows * (cols + 1));
     for(int r = 0; r != rows; ++r){
-        std::string::size_type c = 0;
-        while (c != cols){
-            if( r == 0 || r == rows - 1 || c == 0 || c == cols -1 ){
-                std::cout << "*";
-                ++c;
+        if( r == 0 || r == rows - 1 ){
+            out.append(cols, '*');
+        } else {
+            out += '*';
+            if(r == pad + 1){
+                out.append(pad, ' ');
+                out += greeting;
+                out.append(pad, ' ');
             } else {
-                if(r == pad + 1 && c == pad + 1){
-                    std::cout << greeting;
-                    c += greeting.size();
-                } else {
-                    std::cout << " ";
-                    ++c;
-                }
+                out.append(cols - 2, ' ');
             }
-
+            out += '*';
         }
-        std::cout << std::endl;
+        out += '\n';
     }
+    std::cout.write(out.data(), out.size());
+    std::cout.flush();
 
     return 0;
 }
@@ -6,6 +6,8 @@
 #include <vector>
 #include <stdexcept>
 
+#include "display_width.h"
+
 
 using std::cin;     using std::setprecision;
 using std::cout;    using std::string;
@@ -43,7 +45,7 @@ int main(){
 
     // read and store all records, and fine length of longest name
     while(read(cin, record)){
-        maxlen = std::max(maxlen, record.name.size());
+        maxlen = std::max(maxlen, display_width(record.name));
         students.push_back(record);
     }
 
@@ -53,7 +55,7 @@ int main(){
     for(vector<Student_info>::size_type i = 0; i != students.size(); ++i){
         // write name, padded on right to maxlen + 1
         cout << students[i].name
-             << string(maxlen + 1 - students[i].name.size(), ' ');
+             << string(maxlen + 1 - display_width(students[i].name), ' ');
         
         // compute and generate final grades 
         try {
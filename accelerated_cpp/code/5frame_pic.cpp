@@ -1,13 +1,23 @@
 #include <string> 
 #include <vector> 
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <thread>
+#include <algorithm>
+
+#include "display_width.h"
 
 
 using namespace std;
 
+// widths are in terminal columns, not bytes, so UTF-8 text lines up
 string::size_type width(const vector<string> &v){
     string::size_type maxlen = 0;
     for (vector<string>::size_type i = 0; i != v.size(); ++i)
-        maxlen = max(maxlen, v[i].size());
+        maxlen = max(maxlen, display_width(v[i]));
     return maxlen;
 
 }
@@ -24,7 +34,7 @@ vector<string> frame(const vector<string>& v){
 
     for (vector<string>::size_type i = 0; i != v.size(); i++){
         ret.push_back("* " + v[i] +
-                string(maxlen - v[i].size(), ' ') + " *");
+                string(maxlen - display_width(v[i]), ' ') + " *");
 
     }
 
@@ -44,3 +54,211 @@ vector<string> vcat(const vector<string>& top, const vector<string>& bottom){
     return ret;
 
 }
+
+
+// write rows [b, e) of v framed to maxlen columns starting at p, as
+// "* " + text + padding + " *\n"; returns the end of what was written
+char* frame_rows(const vector<string>& v, vector<string>::size_type b,
+                 vector<string>::size_type e, string::size_type maxlen, char* p){
+    for (; b != e; ++b){
+        *p++ = '*';
+        *p++ = ' ';
+        memcpy(p, v[b].data(), v[b].size());
+        p += v[b].size();
+        string::size_type pad = maxlen - display_width(v[b]);
+        memset(p, ' ', pad);
+        p += pad;
+        memcpy(p, " *\n", 3);
+        p += 3;
+    }
+    return p;
+}
+
+// frame v as text, one '\n'-terminated row per line, into out.
+// the size of the whole picture is known up front, so out is allocated
+// once and borders, content and padding are copied straight into it.
+string& frame_into(const vector<string>& v, string& out){
+    // a row takes "* " + text + padding + " *" + '\n', where text and
+    // padding together span maxlen columns but not always maxlen bytes
+    string::size_type maxlen = 0, bytes = 0, cols = 0;
+    for (vector<string>::size_type i = 0; i != v.size(); ++i){
+        string::size_type w = display_width(v[i]);
+        maxlen = max(maxlen, w);
+        bytes += v[i].size();
+        cols += w;
+    }
+    string::size_type row = maxlen + 5;
+
+    out.resize(row * (v.size() + 2) + bytes - cols);
+    char* p = &out[0];
+
+    memset(p, '*', row - 1);
+    p[row - 1] = '\n';
+    p += row;
+
+    p = frame_rows(v, 0, v.size(), maxlen, p);
+
+    memcpy(p, out.data(), row);                 // bottom border is the top one
+    return out;
+}
+
+
+// frame v without copying its text: fill iov with pieces that writev()
+// can send as is. rows point into v, borders and padding point into
+// scratch, so both must outlive iov.
+//
+// scratch holds   border '\n' | "* " | maxlen spaces | " *\n"
+// so the padding of a row plus its right edge is one contiguous piece.
+vector<iovec>& frame_iov(const vector<string>& v, string& scratch, vector<iovec>& iov){
+    string::size_type maxlen = width(v);
+
+    scratch.assign(maxlen + 4, '*');
+    scratch += '\n';
+    string::size_type left = scratch.size();
+    scratch += "* ";
+    scratch.append(maxlen, ' ');
+    scratch += " *\n";
+
+    char* base = &scratch[0];
+    char* pad_end = base + scratch.size() - 3;
+    iovec border = { base, left };
+
+    iov.clear();
+    iov.reserve(3 * v.size() + 2);
+    iov.push_back(border);
+    for (vector<string>::size_type i = 0; i != v.size(); ++i){
+        iovec edge = { base + left, 2 };
+        iovec text = { const_cast<char*>(v[i].data()), v[i].size() };
+        string::size_type pad = maxlen - display_width(v[i]);
+        iovec rest = { pad_end - pad, pad + 3 };
+        iov.push_back(edge);
+        iov.push_back(text);
+        iov.push_back(rest);
+    }
+    iov.push_back(border);
+    return iov;
+}
+
+
+// writev() all of iov to fd, at most IOV_MAX pieces per call and
+// picking up after short writes; false on error. iov is left as it is:
+// i is the first piece not fully written and off how much of it went out.
+bool write_iov(int fd, const vector<iovec>& iov){
+    vector<iovec>::size_type i = 0;
+    size_t off = 0;
+    while (i != iov.size()){
+        ssize_t written;
+        if (off){
+            // finish the piece a short write cut into before going on
+            written = write(fd, static_cast<const char*>(iov[i].iov_base) + off,
+                            iov[i].iov_len - off);
+        } else {
+            int n = (int)min<vector<iovec>::size_type>(iov.size() - i, IOV_MAX);
+            written = writev(fd, &iov[i], n);
+        }
+        if (written < 0){
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        // skip the pieces that went out completely, remember a partial one
+        size_t w = written + off;
+        off = 0;
+        while (i != iov.size() && w >= iov[i].iov_len)
+            w -= iov[i++].iov_len;
+        off = w;
+    }
+    return true;
+}
+
+
+// per-chunk totals for the parallel versions
+struct Chunk_widths {
+    string::size_type maxlen, bytes, cols;
+};
+
+Chunk_widths chunk_widths(const vector<string>& v,
+                          vector<string>::size_type b, vector<string>::size_type e){
+    Chunk_widths c = { 0, 0, 0 };
+    for (; b != e; ++b){
+        string::size_type w = display_width(v[b]);
+        c.maxlen = max(c.maxlen, w);
+        c.bytes += v[b].size();
+        c.cols += w;
+    }
+    return c;
+}
+
+// run f(k, begin, end) for chunk k of [0, n) on its own thread;
+// chunk k is [k * n / chunks, (k + 1) * n / chunks)
+template<class F>
+void for_each_chunk(vector<string>::size_type n, unsigned chunks, F f){
+    vector<thread> pool;
+    for (unsigned k = 1; k < chunks; ++k)
+        pool.push_back(thread(f, k, k * n / chunks, (k + 1) * n / chunks));
+    f(0u, 0, n / chunks);
+    for (vector<thread>::size_type k = 0; k != pool.size(); ++k)
+        pool[k].join();
+}
+
+unsigned frame_threads(vector<string>::size_type n, unsigned nthreads){
+    // below a few thousand rows threads cost more than they save
+    const vector<string>::size_type min_rows = 4096;
+    if (nthreads == 0)
+        nthreads = 1;
+    return (unsigned)max<vector<string>::size_type>(1, min<vector<string>::size_type>(nthreads, n / min_rows));
+}
+
+
+// width() as a parallel reduction: each thread takes the max of its chunk
+string::size_type width_parallel(const vector<string>& v,
+                                 unsigned nthreads = thread::hardware_concurrency()){
+    unsigned chunks = frame_threads(v.size(), nthreads);
+    vector<string::size_type> part(chunks);
+    for_each_chunk(v.size(), chunks,
+            [&](unsigned k, vector<string>::size_type b, vector<string>::size_type e){
+                part[k] = chunk_widths(v, b, e).maxlen;
+            });
+    return *max_element(part.begin(), part.end());
+}
+
+
+// frame_into() on several threads. each chunk of rows first measures
+// itself; once maxlen is known a prefix sum over the chunk sizes gives
+// every chunk its offset in out, and the chunks are rendered in place
+// concurrently. out is still allocated once.
+string& frame_parallel(const vector<string>& v, string& out,
+                       unsigned nthreads = thread::hardware_concurrency()){
+    typedef vector<string>::size_type vec_sz;
+    unsigned chunks = frame_threads(v.size(), nthreads);
+
+    vector<Chunk_widths> part(chunks);
+    for_each_chunk(v.size(), chunks, [&](unsigned k, vec_sz b, vec_sz e){
+        part[k] = chunk_widths(v, b, e);
+    });
+
+    string::size_type maxlen = 0;
+    for (unsigned k = 0; k != chunks; ++k)
+        maxlen = max(maxlen, part[k].maxlen);
+    string::size_type row = maxlen + 5;
+
+    // offset[k] is where chunk k starts, after the top border
+    vector<string::size_type> offset(chunks + 1);
+    offset[0] = row;
+    for (unsigned k = 0; k != chunks; ++k){
+        vec_sz rows = (k + 1) * v.size() / chunks - k * v.size() / chunks;
+        offset[k + 1] = offset[k] + rows * row + part[k].bytes - part[k].cols;
+    }
+
+    out.resize(offset[chunks] + row);
+    char* base = &out[0];
+    memset(base, '*', row - 1);
+    base[row - 1] = '\n';
+    memcpy(base + offset[chunks], base, row);
+
+    for_each_chunk(v.size(), chunks, [&](unsigned k, vec_sz b, vec_sz e){
+        frame_rows(v, b, e, maxlen, base + offset[k]);
+    });
+    return out;
+}
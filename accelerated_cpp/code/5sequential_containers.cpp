@@ -7,6 +7,8 @@
 #include <stdexcept>
 #include <list>
 
+#include "display_width.h"
+
 
 using namespace std;
 
@@ -41,7 +43,7 @@ int main(){
 
     // read and store all records, and fine length of longest name
     while(read(cin, record)){
-        maxlen = max(maxlen, record.name.size());
+        maxlen = max(maxlen, display_width(record.name));
         students.push_back(record);
     }
 
@@ -51,7 +53,7 @@ int main(){
     for(vector<Student_info>::size_type i = 0; i != students.size(); ++i){
         // write name, padded on right to maxlen + 1
         cout << students[i].name
-             << string(maxlen + 1 - students[i].name.size(), ' ');
+             << string(maxlen + 1 - display_width(students[i].name), ' ');
         
         // compute and generate final grades 
         try {
@@ -3,6 +3,8 @@
 #include <string> 
 #include <vector> 
 
+#include "../../leetcode/include/bitset.h"
+
 using namespace std;
 
 
@@ -59,27 +61,72 @@ map<string, vector<int> > xref(istream& in, vector<string> find_words(const stri
 }
 
 
-int main(){
-    map<string, vector<int> > ret = xref(cin);
+// the same index with each word's lines as a set of bits: a word on a
+// few lines keeps a short sorted array, one on most lines a bitmap, and
+// "lines with all of these words" is a word-parallel intersection
+map<string, RoaringBitmap> xref_index(istream& in, vector<string> find_words(const string&) = split){
+    string line;
+    uint32_t line_number = 0;
+    map<string, RoaringBitmap> ret;
+
+    while(getline(in, line)){
+        ++line_number;
+        vector<string> words = find_words(line);
+        for(vector<string>::const_iterator it = words.begin(); it != words.end(); it++){
+            ret[*it].add(line_number);
+        }
+    }
+
+    return ret;
+}
+
+// lines on which every word in [b, e) occurs
+RoaringBitmap lines_with_all(const map<string, RoaringBitmap>& index,
+                             vector<string>::const_iterator b, vector<string>::const_iterator e){
+    RoaringBitmap ret;
+    for(vector<string>::const_iterator it = b; it != e; ++it){
+        map<string, RoaringBitmap>::const_iterator found = index.find(*it);
+        if(found == index.end())
+            return RoaringBitmap();
+        if(it == b)
+            ret = found->second;
+        else
+            ret &= found->second;
+    }
+    return ret;
+}
+
+void write_lines(const RoaringBitmap& lines){
+    const char* sep = "";
+    lines.forEach([&](uint32_t n){
+        cout << sep << n;
+        sep = ", ";
+    });
+}
+
+
+// with no arguments, list every word and its lines; with words as
+// arguments, list the lines on which all of them occur
+int main(int argc, char** argv){
+    map<string, RoaringBitmap> ret = xref_index(cin);
 
+    if(argc > 1){
+        vector<string> words(argv + 1, argv + argc);
+        cout << "lines with all words: ";
+        write_lines(lines_with_all(ret, words.begin(), words.end()));
+        cout << endl;
+        return 0;
+    }
 
     // write result 
 
-    for(map<string, vector<int> >::const_iterator it = ret.begin();
+    for(map<string, RoaringBitmap>::const_iterator it = ret.begin();
             it != ret.end(); ++it){
 
-        // write word 
+        // write word followed by line numbers
         cout << it->first << " occurs on line(s): ";
+        write_lines(it->second);
 
-        // followed by line numbers
-        vector<int>::const_iterator line_it = it->second.begin();
-        cout << *line_it; // write first line number 
-
-        ++line_it;
-        while(line_it != it->second.end()){
-            cout << ", " << *line_it;
-            ++line_it;
-        }
         // write a new line to separate each word from text
         cout << endl;
     }
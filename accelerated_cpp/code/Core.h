@@ -0,0 +1,145 @@
+#ifndef GUARD_Core_h
+#define GUARD_Core_h
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// compute median
+inline double median(std::vector<double> vec)
+{
+    typedef std::vector<double>::size_type vec_sz;
+    vec_sz size = vec.size();
+
+    if (size == 0)
+        throw std::domain_error("median of an empty vector");
+
+    std::sort(vec.begin(), vec.end());
+
+    vec_sz mid = size / 2;
+    return size % 2 == 0 ? (vec[mid] + vec[mid - 1]) / 2 : vec[mid];
+}
+
+// compute overall grade
+inline double grade(double midterm, double final, double homework)
+{
+    return 0.2 * midterm + 0.4 * final + 0.4 * homework;
+}
+
+inline double grade(double midterm, double final, const std::vector<double> &hw)
+{
+    if (hw.size() == 0)
+        throw std::domain_error("student has done no homework");
+
+    return grade(midterm, final, median(hw));
+}
+
+// read homework grades from input stream into vector<double>
+inline std::istream &read_hw(std::istream &in, std::vector<double> &hw)
+{
+    if (in)
+    {
+        // remove previous state
+        hw.clear();
+
+        double x;
+        while (in >> x)
+            hw.push_back(x);
+
+        // clear stream error state for next student input
+        in.clear();
+    }
+    return in;
+}
+
+class Core
+{
+  public:
+    Core() : midterm(0), final(0){};
+    Core(std::istream &is) { read(is); };
+    virtual ~Core() {}
+    std::string name() const { return n; }
+
+    // number of homework grades, i.e. the cost of grade()
+    std::vector<double>::size_type hw_count() const { return homework.size(); }
+
+    // read-only access to the raw grades, e.g. for writing them out
+    double midterm_grade() const { return midterm; }
+    double final_grade() const { return final; }
+    const std::vector<double> &homework_grades() const { return homework; }
+
+    // virtual: allows dynamic-binding of read() and grade() at runtime
+    virtual std::istream &read(std::istream &);
+    virtual double grade() const;
+
+  protected:
+    // accessible to derived classes
+    std::istream &read_common(std::istream &);
+    double midterm, final;
+    std::vector<double> homework;
+
+  private:
+    // accessible only in Core
+    std::string n;
+};
+
+class Grad : public Core
+{
+  public:
+    Grad() : thesis(0){};
+    Grad(std::istream &is) { read(is); };
+    double thesis_grade() const { return thesis; }
+
+    // virtual by inheritance
+    double grade() const;
+    std::istream &read(std::istream &);
+
+  private:
+    double thesis;
+};
+
+inline double Core::grade() const
+{
+    return ::grade(midterm, final, homework);
+}
+
+inline std::istream &Core::read_common(std::istream &in)
+{
+    // read and store students name and grades
+    in >> n >> midterm >> final;
+    return in;
+}
+
+inline std::istream &Core::read(std::istream &in)
+{
+    read_common(in);
+    read_hw(in, homework);
+    return in;
+}
+
+inline std::istream &Grad::read(std::istream &in)
+{
+    read_common(in);
+    in >> thesis;
+    read_hw(in, homework);
+    return in;
+}
+
+inline double Grad::grade() const
+{
+    return std::min(Core::grade(), thesis);
+}
+
+inline bool compare(const Core &c1, const Core &c2)
+{
+    return c1.name() < c2.name();
+}
+
+inline bool compare_Core_ptrs(const Core *cp1, const Core *cp2)
+{
+    return compare(*cp1, *cp2);
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef GUARD_Pic_h
+#define GUARD_Pic_h
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "display_width.h"
+
+// character pictures as an expression tree (chapter 15). frame, hcat and
+// vcat only allocate a small node pointing at their operands; nothing is
+// copied or rendered until the picture is written to a stream. then every
+// node is visited once and appends its part to each of its output rows,
+// so writing costs O(output) however deep the tree is.
+//
+// widths are display widths (see display_width.h), so pictures of UTF-8
+// text line up on a terminal.
+
+class Picture;
+
+class Pic_base
+{
+    friend std::ostream &operator<<(std::ostream &, const Picture &);
+    friend class Frame_Pic;
+    friend class HCat_Pic;
+    friend class VCat_Pic;
+    friend class String_Pic;
+
+  public:
+    virtual ~Pic_base() {}
+
+  protected:
+    typedef std::vector<std::string>::size_type ht_sz;
+    typedef std::string::size_type wd_sz;
+
+    // sizes are computed once, when the node is built
+    Pic_base(wd_sz w, ht_sz h) : wd(w), ht(h) {}
+    wd_sz width() const { return wd; }
+    ht_sz height() const { return ht; }
+    void set_width(wd_sz w) { wd = w; }
+
+    // append the picture to rows[first], ..., rows[first + height() - 1];
+    // if do_pad, pad each of them out to width()
+    virtual void render(std::vector<std::string> &rows, ht_sz first, bool do_pad) const = 0;
+
+    // pad rows [beg, end) with spaces from column from to column to
+    static void pad(std::vector<std::string> &rows, ht_sz beg, ht_sz end, wd_sz from, wd_sz to)
+    {
+        if (from < to)
+            for (ht_sz i = beg; i != end; ++i)
+                rows[i].append(to - from, ' ');
+    }
+
+  private:
+    wd_sz wd;
+    ht_sz ht;
+};
+
+// interface class, copying a Picture only copies a pointer
+class Picture
+{
+    friend std::ostream &operator<<(std::ostream &, const Picture &);
+    friend Picture frame(const Picture &);
+    friend Picture hcat(const Picture &, const Picture &);
+    friend Picture vcat(const Picture &, const Picture &);
+
+  public:
+    Picture(const std::vector<std::string> & = std::vector<std::string>());
+
+  private:
+    Picture(Pic_base *ptr) : p(ptr) {}
+    std::shared_ptr<const Pic_base> p;
+};
+
+Picture frame(const Picture &);
+Picture hcat(const Picture &, const Picture &);
+Picture vcat(const Picture &, const Picture &);
+std::ostream &operator<<(std::ostream &, const Picture &);
+
+class String_Pic : public Pic_base
+{
+    friend class Picture;
+
+    String_Pic(const std::vector<std::string> &v)
+        : Pic_base(0, v.size()), data(v), widths(v.size())
+    {
+        wd_sz maxlen = 0;
+        for (ht_sz i = 0; i != v.size(); ++i)
+        {
+            widths[i] = display_width(v[i]);
+            maxlen = std::max(maxlen, widths[i]);
+        }
+        set_width(maxlen);
+    }
+
+    void render(std::vector<std::string> &rows, ht_sz first, bool do_pad) const
+    {
+        for (ht_sz i = 0; i != height(); ++i)
+        {
+            rows[first + i] += data[i];
+            if (do_pad)
+                pad(rows, first + i, first + i + 1, widths[i], width());
+        }
+    }
+
+    std::vector<std::string> data;
+    std::vector<wd_sz> widths;
+};
+
+class Frame_Pic : public Pic_base
+{
+    friend Picture frame(const Picture &);
+
+    Frame_Pic(const std::shared_ptr<const Pic_base> &pic)
+        : Pic_base(pic->width() + 4, pic->height() + 2), p(pic) {}
+
+    void render(std::vector<std::string> &rows, ht_sz first, bool) const
+    {
+        // borders are always the full width
+        ht_sz last = first + height() - 1;
+        rows[first].append(width(), '*');
+        for (ht_sz i = first + 1; i != last; ++i)
+            rows[i] += "* ";
+        p->render(rows, first + 1, true);
+        for (ht_sz i = first + 1; i != last; ++i)
+            rows[i] += " *";
+        rows[last].append(width(), '*');
+    }
+
+    std::shared_ptr<const Pic_base> p;
+};
+
+class VCat_Pic : public Pic_base
+{
+    friend Picture vcat(const Picture &, const Picture &);
+
+    VCat_Pic(const std::shared_ptr<const Pic_base> &t, const std::shared_ptr<const Pic_base> &b)
+        : Pic_base(std::max(t->width(), b->width()), t->height() + b->height()),
+          top(t), bottom(b) {}
+
+    void render(std::vector<std::string> &rows, ht_sz first, bool do_pad) const
+    {
+        ht_sz mid = first + top->height();
+        top->render(rows, first, do_pad);
+        bottom->render(rows, mid, do_pad);
+        if (do_pad)
+        {
+            pad(rows, first, mid, top->width(), width());
+            pad(rows, mid, first + height(), bottom->width(), width());
+        }
+    }
+
+    std::shared_ptr<const Pic_base> top, bottom;
+};
+
+class HCat_Pic : public Pic_base
+{
+    friend Picture hcat(const Picture &, const Picture &);
+
+    HCat_Pic(const std::shared_ptr<const Pic_base> &l, const std::shared_ptr<const Pic_base> &r)
+        : Pic_base(l->width() + r->width(), std::max(l->height(), r->height())),
+          left(l), right(r) {}
+
+    void render(std::vector<std::string> &rows, ht_sz first, bool do_pad) const
+    {
+        // the left side is padded on every row, also below its own bottom,
+        // so the right side starts in the same column throughout
+        left->render(rows, first, true);
+        pad(rows, first + left->height(), first + height(), 0, left->width());
+        right->render(rows, first, do_pad);
+        if (do_pad)
+            pad(rows, first + right->height(), first + height(), 0, right->width());
+    }
+
+    std::shared_ptr<const Pic_base> left, right;
+};
+
+inline Picture::Picture(const std::vector<std::string> &v) : p(new String_Pic(v)) {}
+
+inline Picture frame(const Picture &pic)
+{
+    return new Frame_Pic(pic.p);
+}
+
+inline Picture hcat(const Picture &l, const Picture &r)
+{
+    return new HCat_Pic(l.p, r.p);
+}
+
+inline Picture vcat(const Picture &t, const Picture &b)
+{
+    return new VCat_Pic(t.p, b.p);
+}
+
+inline std::ostream &operator<<(std::ostream &os, const Picture &picture)
+{
+    std::vector<std::string> rows(picture.p->height());
+    picture.p->render(rows, 0, false);
+    for (std::vector<std::string>::size_type i = 0; i != rows.size(); ++i)
+    {
+        os.write(rows[i].data(), rows[i].size());
+        os.put('\n');
+    }
+    return os;
+}
+
+#endif
@@ -2,47 +2,107 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <type_traits>
+#include <random>
+
+#include "algo_simd.h"
 
 using namespace std;
 
-template<class T>
+
+// iterators over elements stored next to each other in memory: pointers,
+// and the iterators of vector (but not vector<bool>) and string. C++17
+// has no way to ask an iterator this, so the containers are listed.
+template<class It, class = void> struct is_contiguous_iterator : is_pointer<It> {};
+template<class It>
+struct is_contiguous_iterator<It, enable_if_t<!is_pointer<It>::value>> {
+  typedef typename iterator_traits<It>::value_type V;
+  static const bool value =
+    (!is_same<V, bool>::value &&
+     (is_same<It, typename vector<V>::iterator>::value ||
+      is_same<It, typename vector<V>::const_iterator>::value)) ||
+    is_same<It, string::iterator>::value || is_same<It, string::const_iterator>::value;
+};
+
+// true if It is a contiguous iterator that isn't a pointer: the generic
+// versions below hand such ranges to the pointer overloads further down
+template<class It> constexpr bool forward_to_pointers =
+  is_contiguous_iterator<It>::value && !is_pointer<It>::value;
+
+template<class T> T* find(T* begin, T* end, const typename remove_const<T>::type& x);
+template<class T> T* copy(const T* begin, const T* end, T* dest);
+template<class T> T* copy(T* begin, T* end, T* dest);
+template<class T> void replace(T* beg, T* end, const T& x, const T& y);
+template<class T> void reverse(T* begin, T* end);
 
 
 // input iterator
 template <class In, class X> In find(In begin, In end, const X& x){
-  while(begin != end && *begin != x)
-    ++begin;
-  return begin;
+  if constexpr (forward_to_pointers<In> && is_same<X, typename iterator_traits<In>::value_type>::value){
+    if(begin == end)
+      return end;
+    auto p = &*begin;
+    return begin + (::find(p, p + (end - begin), x) - p);
+  } else {
+    while(begin != end && *begin != x)
+      ++begin;
+    return begin;
+  }
 }
 
 // output iterator
 template<class In, class Out> Out copy(In begin, In end, Out dest){
-  while(begin != end)
-    *dest++ = *begin++;
-  return dest;
+  if constexpr (forward_to_pointers<In> && is_contiguous_iterator<Out>::value &&
+                is_same<typename iterator_traits<In>::value_type,
+                        typename iterator_traits<Out>::value_type>::value){
+    if(begin == end)
+      return dest;
+    auto n = end - begin;
+    ::copy(&*begin, &*begin + n, &*dest);
+    return dest + n;
+  } else {
+    while(begin != end)
+      *dest++ = *begin++;
+    return dest;
+  }
 }
 
 // foward iterator
 template<class For, class X> void replace(For beg, For end, const X& x, const X& y){
-  while(beg != end){
-    if(*beg == x)
-      *beg = y;
-    ++beg;
+  if constexpr (forward_to_pointers<For> && is_same<X, typename iterator_traits<For>::value_type>::value){
+    if(beg != end)
+      ::replace(&*beg, &*beg + (end - beg), x, y);
+  } else {
+    while(beg != end){
+      if(*beg == x)
+        *beg = y;
+      ++beg;
+    }
   }
 }
 
 // bidirectional iterator
-template<class Bi> void reverse(Bi begin, Bi, end){
-  while(begin != end){
-    --end;
+template<class Bi> void reverse(Bi begin, Bi end){
+  if constexpr (forward_to_pointers<Bi>){
     if(begin != end)
-      swap(*begin++, *end)
+      ::reverse(&*begin, &*begin + (end - begin));
+  } else {
+    while(begin != end){
+      --end;
+      if(begin != end)
+        swap(*begin++, *end);
+    }
   }
 }
 
 
 // random access iterator
-template<template Ran, class X> bool binary_search(Ran begin, Ran end, const X& x){
+template<class Ran, class X> bool binary_search(Ran begin, Ran end, const X& x){
   while(begin < end){
     // find mid point
     Ran mid = begin + (end - begin) / 2;
@@ -54,7 +114,203 @@ template<template Ran, class X> bool binary_search(Ran begin, Ran end, const X&
     else return true;
 
   }
-  return false
+  return false;
+}
+
+
+// contiguous ranges
+// pointers are random access iterators too, but they also promise the
+// elements sit next to each other in memory. these overloads are more
+// specialized than the ones above, so the compiler picks them for pointer
+// arguments, and the ones above forward vector and string iterators here;
+// for element types with vector lanes (see algo_simd.h) the loops run 16
+// bytes at a time, anything else keeps the plain loop.
+
+// x must have the element type exactly, find(int*, int*, 2.5) has to keep
+// comparing as double and goes to the generic version
+template<class T> T* find(T* begin, T* end, const typename remove_const<T>::type& x){
+  typedef typename remove_const<T>::type U;
+  if constexpr (has_simd_lanes<U>::value)
+    return const_cast<T*>(simd_find<U>(begin, end, x));
+  else {
+    while(begin != end && *begin != x)
+      ++begin;
+    return begin;
+  }
+}
+
+// trivially copyable elements can be copied as bytes
+template<class T> T* copy(const T* begin, const T* end, T* dest){
+  if constexpr (is_trivially_copyable<T>::value){
+    // memmove wants valid pointers even for 0 bytes, an empty range may have none
+    if(begin != end)
+      memmove(dest, begin, (end - begin) * sizeof(T));
+    return dest + (end - begin);
+  } else {
+    while(begin != end)
+      *dest++ = *begin++;
+    return dest;
+  }
+}
+
+// without this one copy(int*, int*, int*) would pick the generic version,
+// which needs no int* -> const int* conversion
+template<class T> T* copy(T* begin, T* end, T* dest){
+  return ::copy(static_cast<const T*>(begin), static_cast<const T*>(end), dest);
+}
+
+template<class T> void replace(T* beg, T* end, const T& x, const T& y){
+  if constexpr (has_simd_lanes<T>::value)
+    simd_replace<T>(beg, end, x, y);
+  else {
+    while(beg != end){
+      if(*beg == x)
+        *beg = y;
+      ++beg;
+    }
+  }
+}
+
+template<class T> void reverse(T* begin, T* end){
+  if constexpr (has_simd_lanes<T>::value)
+    simd_reverse<T>(begin, end);
+  else {
+    while(begin != end){
+      --end;
+      if(begin != end)
+        swap(*begin++, *end);
+    }
+  }
+}
+
+
+// searching static sorted tables
+// binary_search above branches three ways on every probe, and which way it
+// goes is a coin flip, so on big arrays most probes are mispredicted.
+
+// first position in [begin, end) not less than x. the loop always runs
+// log2(n) times and the only decision is a conditional move, so there is
+// nothing to mispredict.
+template<class T> const T* lower_bound_branchless(const T* begin, const T* end, const T& x){
+  size_t n = end - begin;
+  if(n == 0)
+    return begin;
+  const T* base = begin;
+  while(n > 1){
+    size_t half = n / 2;
+    base = (base[half] < x) ? base + half : base;
+    n -= half;
+  }
+  return base + (*base < x);
+}
+
+template<class T> bool binary_search_branchless(const T* begin, const T* end, const T& x){
+  const T* p = lower_bound_branchless(begin, end, x);
+  return p != end && !(x < *p);
+}
+
+// a sorted table stored in Eytzinger (breadth-first) order: node k has its
+// children at 2k and 2k+1, so the first levels of the search share a few
+// cache lines and the nodes a search will visit next are at a known place,
+// which lets us prefetch several levels ahead.
+template<class T> class Eytzinger {
+public:
+  typedef size_t size_type;
+
+  Eytzinger(const T* begin, const T* end)
+    : t(end - begin + 1), pos(end - begin + 1), n(end - begin) {
+    size_type i = 0;
+    build(begin, i, 1);
+  }
+
+  size_type size() const { return n; }
+
+  // index in the original sorted table of the first element not less
+  // than x, or size() if there is none
+  size_type lower_bound(const T& x) const {
+    size_type k = search(x);
+    return k == 0 ? n : pos[k];
+  }
+
+  bool contains(const T& x) const {
+    size_type k = search(x);
+    return k != 0 && !(x < t[k]);
+  }
+
+  // lower_bound() of each key in [b, e), written through out. keys are
+  // searched a group at a time, all of the group's searches advancing one
+  // level per round, so their cache misses overlap instead of queueing.
+  template<class In, class Out> Out lower_bound_batch(In b, In e, Out out) const {
+    const size_type group = 16;
+    size_type k[group];
+    T key[group];
+    while(b != e){
+      size_type m = 0;
+      for(; m != group && b != e; ++m, ++b){
+        key[m] = *b;
+        k[m] = 1;
+      }
+      for(bool more = n != 0; more; ){
+        more = false;
+        for(size_type j = 0; j != m; ++j){
+          if(k[j] <= n){
+            __builtin_prefetch(&t[0] + prefetch_ahead * k[j]);
+            k[j] = 2 * k[j] + (t[k[j]] < key[j]);
+            more = true;
+          }
+        }
+      }
+      for(size_type j = 0; j != m; ++j){
+        size_type node = answer(k[j]);
+        *out++ = node == 0 ? n : pos[node];
+      }
+    }
+    return out;
+  }
+
+private:
+  // one cache line holds this many elements; prefetching node k times it
+  // fetches the line holding k's descendants four levels down
+  static const size_type prefetch_ahead = 64 / sizeof(T) ? 64 / sizeof(T) : 1;
+
+  // in-order walk of the implicit tree hands out the sorted elements
+  void build(const T* sorted, size_type& i, size_type k){
+    if(k <= n){
+      build(sorted, i, 2 * k);
+      pos[k] = i;
+      t[k] = sorted[i++];
+      build(sorted, i, 2 * k + 1);
+    }
+  }
+
+  // node holding the first element not less than x, 0 if there is none
+  size_type search(const T& x) const {
+    size_type k = 1;
+    while(k <= n){
+      __builtin_prefetch(&t[0] + prefetch_ahead * k);
+      k = 2 * k + (t[k] < x);
+    }
+    return answer(k);
+  }
+
+  // past the answer the search went left once and then right at every
+  // level, so strip the trailing ones and that left turn to get back to it
+  static size_type answer(size_type k) {
+    return k >> __builtin_ffsll(~(unsigned long long)k);
+  }
+
+  vector<T> t;              // t[0] unused
+  vector<size_type> pos;    // pos[k] is where t[k] sits in sorted order
+  size_type n;
+};
+
+
+bool space(char c){
+  return isspace(c);
+}
+
+bool not_space(char c){
+  return !isspace(c);
 }
 
 // split
@@ -77,3 +333,96 @@ template<class Out> void split(const string& str, Out os){
     i = j;
   }
 }
+
+
+// benchmark: each algorithm through deque iterators (generic version)
+// and through vector iterators (forwarded to the contiguous version), on
+// the same values
+
+template<class F> double time_ms(F f, int reps = 20){
+  chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+  for(int r = 0; r != reps; ++r)
+    f();
+  chrono::duration<double, milli> d = chrono::steady_clock::now() - t0;
+  return d.count() / reps;
+}
+
+template<class T> void bench(const string& type, T x, T y){
+  const typename vector<T>::size_type n = 1 << 22;
+  vector<T> v(n), w(n);
+  for(typename vector<T>::size_type i = 0; i != n; ++i)
+    v[i] = T(i % 100);
+  v[n - 1] = x;           // find has to walk the whole range
+
+  deque<T> dv(v.begin(), v.end()), dw(n);
+  size_t sink = 0;
+
+  double gf = time_ms([&]{ sink += ::find(dv.begin(), dv.end(), x) - dv.begin(); });
+  double pf = time_ms([&]{ sink += ::find(v.begin(), v.end(), x) - v.begin(); });
+  double gc = time_ms([&]{ ::copy(dv.begin(), dv.end(), dw.begin()); });
+  double pc = time_ms([&]{ ::copy(v.begin(), v.end(), w.begin()); });
+  double gr = time_ms([&]{ ::replace(dw.begin(), dw.end(), x, y); ::replace(dw.begin(), dw.end(), y, x); });
+  double pr = time_ms([&]{ ::replace(w.begin(), w.end(), x, y); ::replace(w.begin(), w.end(), y, x); });
+  double gv = time_ms([&]{ ::reverse(dw.begin(), dw.end()); });
+  double pv = time_ms([&]{ ::reverse(w.begin(), w.end()); });
+
+  cout << type << " (" << n << " elements, ms generic / contiguous)" << endl
+       << "  find    " << gf << " / " << pf << endl
+       << "  copy    " << gc << " / " << pc << endl
+       << "  replace " << gr / 2 << " / " << pr / 2 << endl
+       << "  reverse " << gv << " / " << pv << endl;
+  if(sink == 0)
+    cout << "";
+}
+
+// lookups of random keys in a sorted table of n ints
+void bench_search(size_t n, size_t queries){
+  vector<int> table(n);
+  for(size_t i = 0; i != n; ++i)
+    table[i] = int(2 * i);                  // even numbers, half the keys miss
+  mt19937 gen(7);
+  uniform_int_distribution<int> key(0, int(2 * n));
+  vector<int> keys(queries);
+  for(size_t i = 0; i != queries; ++i)
+    keys[i] = key(gen);
+
+  const int* b = &table[0];
+  const int* e = b + n;
+  Eytzinger<int> tree(b, e);
+  vector<size_t> found(queries);
+  size_t sink = 0;
+
+  double classic = time_ms([&]{
+    for(size_t i = 0; i != queries; ++i) sink += ::binary_search(table.begin(), table.end(), keys[i]); }, 3);
+  double branchless = time_ms([&]{
+    for(size_t i = 0; i != queries; ++i) sink += lower_bound_branchless(b, e, keys[i]) - b; }, 3);
+  double eytzinger = time_ms([&]{
+    for(size_t i = 0; i != queries; ++i) sink += tree.lower_bound(keys[i]); }, 3);
+  double batched = time_ms([&]{
+    tree.lower_bound_batch(keys.begin(), keys.end(), found.begin()); sink += found[0]; }, 3);
+
+  // all of them must agree with the standard library
+  for(size_t i = 0; i != queries; ++i){
+    size_t expect = std::lower_bound(b, e, keys[i]) - b;
+    if(size_t(lower_bound_branchless(b, e, keys[i]) - b) != expect || tree.lower_bound(keys[i]) != expect ||
+       found[i] != expect || ::binary_search(b, e, keys[i]) != tree.contains(keys[i]))
+      cout << "mismatch for key " << keys[i] << endl;
+  }
+
+  cout << "search " << n << " ints, " << queries << " keys (ns/lookup)" << endl
+       << "  binary_search " << classic * 1e6 / queries << endl
+       << "  branchless    " << branchless * 1e6 / queries << endl
+       << "  eytzinger     " << eytzinger * 1e6 / queries << endl
+       << "  batched       " << batched * 1e6 / queries << endl;
+  if(sink == 0)
+    cout << "";
+}
+
+int main(){
+  bench<int>("int", 1000, 2000);
+  bench<double>("double", 1000.5, 2000.5);
+  bench<char>("char", '~', '!');
+  bench_search(1 << 10, 1 << 20);
+  bench_search(1 << 24, 1 << 20);
+  return 0;
+}
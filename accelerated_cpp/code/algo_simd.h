@@ -0,0 +1,158 @@
+#ifndef GUARD_algo_simd_h
+#define GUARD_algo_simd_h
+
+#include <cstddef>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// 16-byte vector kernels for find, replace and reverse over contiguous
+// arrays. simd_lanes<T> says how to compare, select and reverse lanes of
+// one element type; types without a specialization (and builds without
+// SSE2) have has_simd_lanes<T>::value == false and stay on scalar loops.
+
+template <class T>
+struct simd_lanes;
+
+template <class T, class = void>
+struct has_simd_lanes : std::false_type
+{
+};
+
+template <class T>
+struct has_simd_lanes<T, decltype(void(sizeof(simd_lanes<T>)))> : std::true_type
+{
+};
+
+#ifdef __SSE2__
+
+// one byte per lane
+template <class T>
+struct lanes_i8
+{
+    typedef __m128i reg;
+    static const std::ptrdiff_t n = 16;
+    static reg load(const T *p) { return _mm_loadu_si128(reinterpret_cast<const reg *>(p)); }
+    static void store(T *p, reg v) { _mm_storeu_si128(reinterpret_cast<reg *>(p), v); }
+    static reg set1(T x) { return _mm_set1_epi8((char)x); }
+    static reg eq(reg a, reg b) { return _mm_cmpeq_epi8(a, b); }
+    static int mask(reg m) { return _mm_movemask_epi8(m); }
+    static reg select(reg m, reg a, reg b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static reg reverse(reg v)
+    {
+        // swap bytes within 16-bit words, then reverse the words
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+};
+
+// four bytes per lane
+template <class T>
+struct lanes_i32
+{
+    typedef __m128i reg;
+    static const std::ptrdiff_t n = 4;
+    static reg load(const T *p) { return _mm_loadu_si128(reinterpret_cast<const reg *>(p)); }
+    static void store(T *p, reg v) { _mm_storeu_si128(reinterpret_cast<reg *>(p), v); }
+    static reg set1(T x) { return _mm_set1_epi32((int)x); }
+    static reg eq(reg a, reg b) { return _mm_cmpeq_epi32(a, b); }
+    static int mask(reg m) { return _mm_movemask_ps(_mm_castsi128_ps(m)); }
+    static reg select(reg m, reg a, reg b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static reg reverse(reg v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+};
+
+template <>
+struct simd_lanes<float>
+{
+    typedef __m128 reg;
+    static const std::ptrdiff_t n = 4;
+    static reg load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, reg v) { _mm_storeu_ps(p, v); }
+    static reg set1(float x) { return _mm_set1_ps(x); }
+    static reg eq(reg a, reg b) { return _mm_cmpeq_ps(a, b); }
+    static int mask(reg m) { return _mm_movemask_ps(m); }
+    static reg select(reg m, reg a, reg b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static reg reverse(reg v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+};
+
+template <>
+struct simd_lanes<double>
+{
+    typedef __m128d reg;
+    static const std::ptrdiff_t n = 2;
+    static reg load(const double *p) { return _mm_loadu_pd(p); }
+    static void store(double *p, reg v) { _mm_storeu_pd(p, v); }
+    static reg set1(double x) { return _mm_set1_pd(x); }
+    static reg eq(reg a, reg b) { return _mm_cmpeq_pd(a, b); }
+    static int mask(reg m) { return _mm_movemask_pd(m); }
+    static reg select(reg m, reg a, reg b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+    static reg reverse(reg v) { return _mm_shuffle_pd(v, v, 1); }
+};
+
+template <> struct simd_lanes<char> : lanes_i8<char> {};
+template <> struct simd_lanes<signed char> : lanes_i8<signed char> {};
+template <> struct simd_lanes<unsigned char> : lanes_i8<unsigned char> {};
+template <> struct simd_lanes<int> : lanes_i32<int> {};
+template <> struct simd_lanes<unsigned> : lanes_i32<unsigned> {};
+
+#endif
+
+// first element equal to x, or e
+template <class T>
+const T *simd_find(const T *b, const T *e, T x)
+{
+    typedef simd_lanes<T> L;
+    typename L::reg vx = L::set1(x);
+    for (; e - b >= L::n; b += L::n)
+    {
+        int m = L::mask(L::eq(L::load(b), vx));
+        if (m)
+            return b + __builtin_ctz(m);
+    }
+    while (b != e && !(*b == x))
+        ++b;
+    return b;
+}
+
+// every element equal to x becomes y: compare, then blend, no branches
+template <class T>
+void simd_replace(T *b, T *e, T x, T y)
+{
+    typedef simd_lanes<T> L;
+    typename L::reg vx = L::set1(x), vy = L::set1(y);
+    for (; e - b >= L::n; b += L::n)
+    {
+        typename L::reg v = L::load(b);
+        L::store(b, L::select(L::eq(v, vx), vy, v));
+    }
+    for (; b != e; ++b)
+        if (*b == x)
+            *b = y;
+}
+
+// swap whole vectors from both ends, reversing lanes on the way
+template <class T>
+void simd_reverse(T *b, T *e)
+{
+    typedef simd_lanes<T> L;
+    for (; e - b >= 2 * L::n; b += L::n)
+    {
+        e -= L::n;
+        typename L::reg front = L::load(b), back = L::load(e);
+        L::store(b, L::reverse(back));
+        L::store(e, L::reverse(front));
+    }
+    while (b < e)
+    {
+        --e;
+        T tmp = *b;
+        *b++ = *e;
+        *e = tmp;
+    }
+}
+
+#endif
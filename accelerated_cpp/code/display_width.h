@@ -0,0 +1,189 @@
+#ifndef GUARD_display_width_h
+#define GUARD_display_width_h
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// how many terminal columns a UTF-8 string takes up. plain ASCII is one
+// column per byte and is recognized with a vector test on the high bits,
+// anything else is decoded and looked up in the tables below.
+
+// true if none of the n bytes at p has its high bit set
+inline bool is_ascii(const char *p, std::string::size_type n)
+{
+    const char *end = p + n;
+#ifdef __SSE2__
+    __m128i bits = _mm_setzero_si128();
+    for (; end - p >= 16; p += 16)
+        bits = _mm_or_si128(bits, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    if (_mm_movemask_epi8(bits))
+        return false;
+#else
+    std::uint64_t bits = 0;
+    for (; end - p >= 8; p += 8)
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        bits |= w;
+    }
+    if (bits & 0x8080808080808080ull)
+        return false;
+#endif
+    unsigned char tail = 0;
+    for (; p != end; ++p)
+        tail |= *p;
+    return tail < 0x80;
+}
+
+// decode the code point at p and advance p past it. malformed or truncated
+// sequences decode to U+FFFD one byte at a time, so p always moves forward.
+inline char32_t decode_utf8(const char *&p, const char *end)
+{
+    const char32_t bad = 0xFFFD;
+    unsigned char c = *p++;
+    if (c < 0x80)
+        return c;
+
+    int more;
+    char32_t cp;
+    if (c >= 0xC2 && c <= 0xDF)
+    {
+        more = 1;
+        cp = c & 0x1F;
+    }
+    else if (c >= 0xE0 && c <= 0xEF)
+    {
+        more = 2;
+        cp = c & 0x0F;
+    }
+    else if (c >= 0xF0 && c <= 0xF4)
+    {
+        more = 3;
+        cp = c & 0x07;
+    }
+    else
+    {
+        return bad;
+    }
+
+    if (end - p < more)
+        return bad;
+    for (int i = 0; i != more; ++i)
+    {
+        unsigned char cc = p[i];
+        if ((cc & 0xC0) != 0x80)
+            return bad;
+        cp = (cp << 6) | (cc & 0x3F);
+    }
+
+    // reject overlong forms, surrogates and anything past U+10FFFF
+    if ((more == 2 && cp < 0x800) || (more == 3 && (cp < 0x10000 || cp > 0x10FFFF)) ||
+        (cp >= 0xD800 && cp <= 0xDFFF))
+        return bad;
+    p += more;
+    return cp;
+}
+
+struct Width_range
+{
+    char32_t first, last;
+};
+
+// combining marks, zero-width spaces/joiners and variation selectors
+const Width_range zero_width_table[] = {
+    {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x05BF, 0x05BF},
+    {0x05C1, 0x05C2}, {0x05C4, 0x05C5}, {0x05C7, 0x05C7}, {0x0610, 0x061A},
+    {0x064B, 0x065F}, {0x0670, 0x0670}, {0x06D6, 0x06DC}, {0x06DF, 0x06E4},
+    {0x06E7, 0x06E8}, {0x06EA, 0x06ED}, {0x0900, 0x0902}, {0x093A, 0x093A},
+    {0x093C, 0x093C}, {0x0941, 0x0948}, {0x094D, 0x094D}, {0x0951, 0x0957},
+    {0x0E31, 0x0E31}, {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, {0x1AB0, 0x1AFF},
+    {0x1DC0, 0x1DFF}, {0x200B, 0x200F}, {0x202A, 0x202E}, {0x2060, 0x2064},
+    {0x20D0, 0x20FF}, {0x302A, 0x302D}, {0x3099, 0x309A}, {0xFE00, 0xFE0F},
+    {0xFE20, 0xFE2F}, {0xFEFF, 0xFEFF}, {0x1F3FB, 0x1F3FF}, {0xE0001, 0xE007F},
+    {0xE0100, 0xE01EF},
+};
+
+// East Asian Wide and Fullwidth characters, plus emoji shown as wide
+const Width_range wide_table[] = {
+    {0x1100, 0x115F}, {0x231A, 0x231B}, {0x2329, 0x232A}, {0x23E9, 0x23EC},
+    {0x23F0, 0x23F0}, {0x23F3, 0x23F3}, {0x25FD, 0x25FE}, {0x2614, 0x2615},
+    {0x2648, 0x2653}, {0x267F, 0x267F}, {0x2693, 0x2693}, {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB}, {0x26BD, 0x26BE}, {0x26C4, 0x26C5}, {0x26CE, 0x26CE},
+    {0x26D4, 0x26D4}, {0x26EA, 0x26EA}, {0x26F2, 0x26F3}, {0x26F5, 0x26F5},
+    {0x26FA, 0x26FA}, {0x26FD, 0x26FD}, {0x2705, 0x2705}, {0x270A, 0x270B},
+    {0x2728, 0x2728}, {0x274C, 0x274C}, {0x274E, 0x274E}, {0x2753, 0x2755},
+    {0x2757, 0x2757}, {0x2795, 0x2797}, {0x27B0, 0x27B0}, {0x27BF, 0x27BF},
+    {0x2B1B, 0x2B1C}, {0x2B50, 0x2B50}, {0x2B55, 0x2B55}, {0x2E80, 0x303E},
+    {0x3041, 0x33FF}, {0x3400, 0x4DBF}, {0x4E00, 0x9FFF}, {0xA000, 0xA4CF},
+    {0xA960, 0xA97F}, {0xAC00, 0xD7A3}, {0xF900, 0xFAFF}, {0xFE10, 0xFE19},
+    {0xFE30, 0xFE6F}, {0xFF00, 0xFF60}, {0xFFE0, 0xFFE6}, {0x16FE0, 0x16FE4},
+    {0x17000, 0x18CFF}, {0x1B000, 0x1B2FF}, {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF},
+    {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F2FF}, {0x1F300, 0x1F64F},
+    {0x1F680, 0x1F6FF}, {0x1F7E0, 0x1F7EB}, {0x1F90C, 0x1F9FF}, {0x1FA70, 0x1FAFF},
+    {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+};
+
+// binary search in a sorted table of disjoint ranges
+template <std::size_t N>
+bool in_table(const Width_range (&table)[N], char32_t cp)
+{
+    if (cp < table[0].first || cp > table[N - 1].last)
+        return false;
+    std::size_t lo = 0, hi = N;
+    while (lo < hi)
+    {
+        std::size_t mid = lo + (hi - lo) / 2;
+        if (cp > table[mid].last)
+            lo = mid + 1;
+        else if (cp < table[mid].first)
+            hi = mid;
+        else
+            return true;
+    }
+    return false;
+}
+
+inline std::string::size_type codepoint_width(char32_t cp)
+{
+    if (cp < 0x300)
+        return cp >= 0x80 && cp < 0xA0 ? 0 : 1; // C1 controls take no space
+    if (in_table(zero_width_table, cp))
+        return 0;
+    return in_table(wide_table, cp) ? 2 : 1;
+}
+
+// display width of n bytes of UTF-8 at p
+inline std::string::size_type display_width(const char *p, std::string::size_type n)
+{
+    if (is_ascii(p, n))
+        return n;
+
+    const char *end = p + n;
+    std::string::size_type w = 0;
+    while (p != end)
+    {
+        // runs of ASCII don't need decoding
+        if ((unsigned char)*p < 0x80)
+        {
+            ++w;
+            ++p;
+        }
+        else
+        {
+            w += codepoint_width(decode_utf8(p, end));
+        }
+    }
+    return w;
+}
+
+inline std::string::size_type display_width(const std::string &s)
+{
+    return display_width(s.data(), s.size());
+}
+
+#endif
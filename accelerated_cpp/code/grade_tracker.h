@@ -0,0 +1,96 @@
+#ifndef GUARD_grade_tracker_h
+#define GUARD_grade_tracker_h
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "Core.h"
+
+// median of a growing sequence, O(log n) per add and O(1) per query.
+// the lower half lives in a max-heap and the upper half in a min-heap;
+// the lower half is never smaller and never more than one element bigger.
+class Running_median
+{
+  public:
+    void add(double x)
+    {
+        if (lower.empty() || x <= lower.top())
+            lower.push(x);
+        else
+            upper.push(x);
+
+        // rebalance so that lower.size() is upper.size() or upper.size() + 1
+        if (lower.size() > upper.size() + 1)
+        {
+            upper.push(lower.top());
+            lower.pop();
+        }
+        else if (upper.size() > lower.size())
+        {
+            lower.push(upper.top());
+            upper.pop();
+        }
+    }
+
+    std::vector<double>::size_type size() const { return lower.size() + upper.size(); }
+
+    // same value as median() over everything added so far
+    double median() const
+    {
+        if (lower.empty())
+            throw std::domain_error("median of an empty vector");
+        return lower.size() == upper.size() ? (lower.top() + upper.top()) / 2
+                                            : lower.top();
+    }
+
+  private:
+    std::priority_queue<double> lower;
+    std::priority_queue<double, std::vector<double>, std::greater<double> > upper;
+};
+
+// keeps a student's final grade up to date as homework grades arrive,
+// without re-sorting their homework on every new score
+class Grade_tracker
+{
+  public:
+    Grade_tracker()
+        : midterm(0), final(0), thesis(std::numeric_limits<double>::infinity()) {}
+
+    // start from a student's current record
+    explicit Grade_tracker(const Core &c)
+        : midterm(c.midterm_grade()), final(c.final_grade()),
+          thesis(std::numeric_limits<double>::infinity())
+    {
+        if (const Grad *g = dynamic_cast<const Grad *>(&c))
+            thesis = g->thesis_grade();
+        const std::vector<double> &hw = c.homework_grades();
+        for (std::vector<double>::size_type i = 0; i != hw.size(); ++i)
+            hw_median.add(hw[i]);
+    }
+
+    // record one more homework grade and return the new final grade
+    double add_homework(double x)
+    {
+        hw_median.add(x);
+        return grade();
+    }
+
+    // same rules as Core::grade() and Grad::grade(), an undergraduate
+    // simply has no thesis grade to cap the result
+    double grade() const
+    {
+        if (hw_median.size() == 0)
+            throw std::domain_error("student has done no homework");
+        return std::min(::grade(midterm, final, hw_median.median()), thesis);
+    }
+
+  private:
+    double midterm, final, thesis;
+    Running_median hw_median;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef GUARD_rank_h
+#define GUARD_rank_h
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+// ranking queries over a dense array of grades, e.g. the output of
+// grade_all(). students are identified by their index in that array and
+// NaN grades (no homework) never rank.
+
+typedef std::vector<double>::size_type rank_sz;
+
+// true if student a ranks above student b: higher grade, then lower index
+inline bool ranks_above(const std::vector<double> &g, rank_sz a, rank_sz b)
+{
+    return g[a] > g[b] || (g[a] == g[b] && a < b);
+}
+
+// indices of the k best students, best first, in O(n log k).
+// a min-heap holds the k best seen so far, its top is the one to beat.
+inline std::vector<rank_sz> top_k(const std::vector<double> &g, rank_sz k)
+{
+    std::vector<rank_sz> heap;
+    // a k past the roster just means everyone
+    k = std::min(k, g.size());
+    if (k == 0)
+        return heap;
+    heap.reserve(k);
+
+    // heap order puts the lowest-ranked student at heap.front()
+    auto worse = [&](rank_sz a, rank_sz b) { return ranks_above(g, a, b); };
+
+    for (rank_sz i = 0; i != g.size(); ++i)
+    {
+        if (std::isnan(g[i]))
+            continue;
+        if (heap.size() < k)
+        {
+            heap.push_back(i);
+            std::push_heap(heap.begin(), heap.end(), worse);
+        }
+        else if (ranks_above(g, i, heap.front()))
+        {
+            std::pop_heap(heap.begin(), heap.end(), worse);
+            heap.back() = i;
+            std::push_heap(heap.begin(), heap.end(), worse);
+        }
+    }
+
+    // only the k survivors get sorted
+    std::sort_heap(heap.begin(), heap.end(), worse);
+    return heap;
+}
+
+// the grade at percentile p (0 <= p <= 100), using the nearest-rank method,
+// found by selection in O(n) rather than by sorting
+inline double percentile(const std::vector<double> &g, double p)
+{
+    // written so that NaN fails it too
+    if (!(p >= 0 && p <= 100))
+        throw std::domain_error("percentile out of range");
+
+    std::vector<double> v;
+    v.reserve(g.size());
+    for (rank_sz i = 0; i != g.size(); ++i)
+        if (!std::isnan(g[i]))
+            v.push_back(g[i]);
+    if (v.empty())
+        throw std::domain_error("percentile of no grades");
+
+    // nearest rank: the smallest grade with at least p% of grades <= it.
+    // p / 100 isn't exact in binary (7 / 100 * 100 is 7.000000000000001),
+    // so whole percentiles are ranked in integers, and other p only after
+    // taking off more than the rounding error
+    rank_sz rank;
+    if (p == std::floor(p))
+        rank = ((rank_sz)p * v.size() + 99) / 100;
+    else
+    {
+        double x = p * v.size() / 100;
+        rank = (rank_sz)std::ceil(x - x * 1e-12);
+    }
+    std::vector<double>::iterator nth = v.begin() + (rank == 0 ? 0 : rank - 1);
+    std::nth_element(v.begin(), nth, v.end());
+    return *nth;
+}
+
+// indices of students whose grade is at least cutoff, in roster order
+inline std::vector<rank_sz> at_or_above(const std::vector<double> &g, double cutoff)
+{
+    std::vector<rank_sz> ret;
+    for (rank_sz i = 0; i != g.size(); ++i)
+        if (g[i] >= cutoff)
+            ret.push_back(i);
+    return ret;
+}
+
+// count grades in nbuckets equal-width buckets over [lo, hi]; grades outside
+// the range are clamped into the first or last bucket
+inline std::vector<rank_sz> histogram(const std::vector<double> &g, double lo,
+                                      double hi, rank_sz nbuckets)
+{
+    if (nbuckets == 0 || !(lo < hi))
+        throw std::domain_error("bad histogram range");
+
+    std::vector<rank_sz> counts(nbuckets, 0);
+    const double scale = nbuckets / (hi - lo);
+    for (rank_sz i = 0; i != g.size(); ++i)
+    {
+        if (std::isnan(g[i]))
+            continue;
+        double b = (g[i] - lo) * scale;
+        rank_sz bucket = b <= 0 ? 0 : std::min((rank_sz)b, nbuckets - 1);
+        ++counts[bucket];
+    }
+    return counts;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "rank.h"
+
+using namespace std;
+
+// checks for the ranking queries in rank.h; run by "make test"
+
+static bool throws_domain_error(const vector<double> &g, double p)
+{
+    try
+    {
+        percentile(g, p);
+    }
+    catch (const domain_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    const double nan = numeric_limits<double>::quiet_NaN();
+    vector<double> g = {70, nan, 95, 80, 95};
+
+    // best first, ties by index, NaN never ranks
+    vector<rank_sz> best = top_k(g, 2);
+    assert((best == vector<rank_sz>{2, 4}));
+    assert(top_k(g, 0).empty());
+
+    // a k past the roster is everyone who has a grade, without
+    // reserving room for k
+    vector<rank_sz> all = {2, 4, 3, 0};
+    assert(top_k(g, 5) == all);
+    assert(top_k(g, 2000000000) == all);
+    assert(top_k(g, numeric_limits<rank_sz>::max()) == all);
+    assert(top_k(vector<double>(), 10).empty());
+
+    assert(percentile(g, 0) == 70);
+    assert(percentile(g, 50) == 80);
+    assert(percentile(g, 100) == 95);
+    assert(throws_domain_error(g, -1));
+    assert(throws_domain_error(g, 100.5));
+    assert(throws_domain_error(g, nan));
+    assert(throws_domain_error(vector<double>{nan}, 50));
+
+    cout << "rank_test: ok" << endl;
+    return 0;
+}
@@ -0,0 +1,100 @@
+#ifndef GUARD_report_format_h
+#define GUARD_report_format_h
+
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "display_width.h"
+
+// writes "name<padding>grade" report rows into a fixed buffer that is
+// flushed to the stream as it fills up. the column layout is computed once,
+// so a row costs a few memcpy's: no temporary padding strings and no
+// precision changes on the stream.
+class Report_writer
+{
+  public:
+    // names are padded on the right to maxlen + 1 columns, as in the
+    // chapter 4 report; maxlen and padding are display widths
+    Report_writer(std::ostream &os, std::string::size_type maxlen)
+        : out(os), col(maxlen + 1), used(0) {}
+    ~Report_writer() { flush(); }
+
+    // grade written like setprecision(3) would, i.e. %.3g
+    void row(const std::string &name, double grade)
+    {
+        char *p = start_row(name);
+        p = std::to_chars(p, p + grade_width, grade, std::chars_format::general, 3).ptr;
+        *p++ = '\n';
+        used = p - buf;
+    }
+
+    // a row with a message instead of a grade, e.g. domain_error::what()
+    void row(const std::string &name, const char *msg)
+    {
+        std::string::size_type len = std::strlen(msg);
+        char *p = start_row(name);
+        while (len > (std::string::size_type)(buf + size - p) - 1)
+        {
+            // message longer than what's left of the buffer
+            std::string::size_type n = buf + size - p;
+            std::memcpy(p, msg, n);
+            msg += n;
+            len -= n;
+            used = size;
+            flush();
+            p = buf;
+        }
+        std::memcpy(p, msg, len);
+        p += len;
+        *p++ = '\n';
+        used = p - buf;
+    }
+
+    void flush()
+    {
+        out.write(buf, used);
+        used = 0;
+    }
+
+  private:
+    Report_writer(const Report_writer &);
+    Report_writer &operator=(const Report_writer &);
+
+    // widest %.3g of a double is "-1.23e+308"
+    static const std::string::size_type grade_width = 16;
+    static const std::string::size_type size = 1 << 16;
+
+    // copy the name and its padding, making room for them first
+    char *start_row(const std::string &name)
+    {
+        std::string::size_type w = display_width(name);
+        std::string::size_type pad = w < col ? col - w : 1;
+        std::string::size_type need = name.size() + pad + grade_width + 1;
+        if (need > size - used)
+            flush();
+
+        if (need > size)
+        {
+            // too wide for the buffer: name and padding go straight out
+            out.write(name.data(), name.size());
+            std::memset(buf, ' ', size);
+            for (; pad > size; pad -= size)
+                out.write(buf, size);
+            out.write(buf, pad);
+            return buf;
+        }
+
+        char *p = buf + used;
+        std::memcpy(p, name.data(), name.size());
+        std::memset(p + name.size(), ' ', pad);
+        return p + name.size() + pad;
+    }
+
+    std::ostream &out;
+    std::string::size_type col, used;
+    char buf[size];
+};
+
+#endif
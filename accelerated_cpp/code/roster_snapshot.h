@@ -0,0 +1,271 @@
+#ifndef GUARD_roster_snapshot_h
+#define GUARD_roster_snapshot_h
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Core.h"
+
+// binary, column-oriented image of a roster that can be mapped straight into
+// memory. all sections start on an 8-byte boundary, in this order:
+//
+//   Snapshot_header
+//   name_off[count + 1]   uint64, name i is pool[name_off[i], name_off[i+1])
+//   hw_off[count + 1]     uint64, homework of i is hw[hw_off[i], hw_off[i+1])
+//   midterm[count]        double
+//   final[count]          double
+//   thesis[count]         double, NaN for undergraduates
+//   hw[hw_total]          double
+//   pool[pool_size]       name characters, not null-terminated
+//
+// numbers are stored in host byte order; a snapshot is a cache for the
+// machine that wrote it, the text format stays the interchange format.
+struct Snapshot_header
+{
+    char magic[8];
+    std::uint64_t count;
+    std::uint64_t hw_total;
+    std::uint64_t pool_size;
+};
+
+const char snapshot_magic[8] = {'R', 'O', 'S', 'T', 'E', 'R', '0', '1'};
+
+class Roster_snapshot
+{
+  public:
+    typedef std::uint64_t size_type;
+
+    explicit Roster_snapshot(const std::string &path);
+    ~Roster_snapshot() { munmap(base, length); }
+
+    size_type size() const { return hdr->count; }
+
+    std::string_view name(size_type i) const
+    {
+        return std::string_view(pool + name_off[i], name_off[i + 1] - name_off[i]);
+    }
+    bool is_grad(size_type i) const { return thesis[i] == thesis[i]; }
+    double midterm_grade(size_type i) const { return midterm[i]; }
+    double final_grade(size_type i) const { return final[i]; }
+    double thesis_grade(size_type i) const { return thesis[i]; }
+
+    // homework grades of student i as [hw_begin(i), hw_end(i))
+    const double *hw_begin(size_type i) const { return hw + hw_off[i]; }
+    const double *hw_end(size_type i) const { return hw + hw_off[i + 1]; }
+
+  private:
+    // mapping owns the file contents, so snapshots can't be copied
+    Roster_snapshot(const Roster_snapshot &);
+    Roster_snapshot &operator=(const Roster_snapshot &);
+
+    void *base;
+    size_t length;
+
+    const Snapshot_header *hdr;
+    const std::uint64_t *name_off, *hw_off;
+    const double *midterm, *final, *thesis, *hw;
+    const char *pool;
+};
+
+// off[0..n] start at 0, never decrease and end at total, so every
+// [off[i], off[i+1]) lies inside its section
+inline bool offsets_ok(const std::uint64_t *off, std::uint64_t n, std::uint64_t total)
+{
+    if (off[0] != 0 || off[n] != total)
+        return false;
+    for (std::uint64_t i = 0; i != n; ++i)
+        if (off[i] > off[i + 1])
+            return false;
+    return true;
+}
+
+inline Roster_snapshot::Roster_snapshot(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Snapshot_header))
+    {
+        close(fd);
+        throw std::runtime_error(path + " is not a roster snapshot");
+    }
+
+    length = st.st_size;
+    base = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        throw std::runtime_error("cannot map " + path);
+
+    // everything below is pointer arithmetic, nothing is parsed
+    const char *p = static_cast<const char *>(base);
+    hdr = reinterpret_cast<const Snapshot_header *>(p);
+
+    // each size is checked against the file before it is used, so a corrupt
+    // header can't make the total wrap around
+    size_type n = hdr->count;
+    std::uint64_t room = length - sizeof(Snapshot_header);
+    bool fits = n <= room / 40 && hdr->hw_total <= room / 8 && hdr->pool_size <= room;
+    if (std::memcmp(hdr->magic, snapshot_magic, 8) != 0 || !fits ||
+        16 + 40 * n + 8 * hdr->hw_total + hdr->pool_size > room)
+    {
+        munmap(base, length);
+        throw std::runtime_error(path + " is not a roster snapshot");
+    }
+
+    p += sizeof(Snapshot_header);
+    name_off = reinterpret_cast<const std::uint64_t *>(p);
+    p += (n + 1) * 8;
+    hw_off = reinterpret_cast<const std::uint64_t *>(p);
+    p += (n + 1) * 8;
+    midterm = reinterpret_cast<const double *>(p);
+    p += n * 8;
+    final = reinterpret_cast<const double *>(p);
+    p += n * 8;
+    thesis = reinterpret_cast<const double *>(p);
+    p += n * 8;
+    hw = reinterpret_cast<const double *>(p);
+    p += hdr->hw_total * 8;
+    pool = p;
+
+    if (!offsets_ok(name_off, n, hdr->pool_size) || !offsets_ok(hw_off, n, hdr->hw_total))
+    {
+        munmap(base, length);
+        throw std::runtime_error(path + " is a corrupt roster snapshot");
+    }
+}
+
+// grade student i straight from the columns, same rules as Core/Grad::grade()
+inline double grade(const Roster_snapshot &s, Roster_snapshot::size_type i)
+{
+    double g = grade(s.midterm_grade(i), s.final_grade(i),
+                     std::vector<double>(s.hw_begin(i), s.hw_end(i)));
+    return s.is_grad(i) ? std::min(g, s.thesis_grade(i)) : g;
+}
+
+// columns of a snapshot being built up in memory
+class Snapshot_writer
+{
+  public:
+    void add(const Core &c)
+    {
+        const Grad *g = dynamic_cast<const Grad *>(&c);
+        add(c.name(), c.midterm_grade(), c.final_grade(),
+            g ? g->thesis_grade() : std::numeric_limits<double>::quiet_NaN(),
+            c.homework_grades());
+    }
+
+    void add(const std::string &name, double mid, double fin, double th,
+             const std::vector<double> &homework)
+    {
+        if (name_off.empty())
+        {
+            name_off.push_back(0);
+            hw_off.push_back(0);
+        }
+        pool += name;
+        name_off.push_back(pool.size());
+        hw.insert(hw.end(), homework.begin(), homework.end());
+        hw_off.push_back(hw.size());
+        midterm.push_back(mid);
+        final.push_back(fin);
+        thesis.push_back(th);
+    }
+
+    void write(const std::string &path) const;
+
+  private:
+    std::vector<std::uint64_t> name_off, hw_off;
+    std::vector<double> midterm, final, thesis, hw;
+    std::string pool;
+};
+
+template <class T>
+void write_column(std::ostream &os, const std::vector<T> &v)
+{
+    if (!v.empty())
+        os.write(reinterpret_cast<const char *>(&v[0]), v.size() * sizeof(T));
+}
+
+inline void Snapshot_writer::write(const std::string &path) const
+{
+    std::ofstream os(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!os)
+        throw std::runtime_error("cannot create " + path);
+
+    Snapshot_header h;
+    std::memcpy(h.magic, snapshot_magic, 8);
+    h.count = midterm.size();
+    h.hw_total = hw.size();
+    h.pool_size = pool.size();
+    os.write(reinterpret_cast<const char *>(&h), sizeof(h));
+
+    // an empty roster still has the closing offset of each table
+    std::vector<std::uint64_t> zero(1, 0);
+    write_column(os, name_off.empty() ? zero : name_off);
+    write_column(os, hw_off.empty() ? zero : hw_off);
+    write_column(os, midterm);
+    write_column(os, final);
+    write_column(os, thesis);
+    write_column(os, hw);
+    os.write(pool.data(), pool.size());
+
+    if (!os)
+        throw std::runtime_error("error writing " + path);
+}
+
+// read a roster in the text format (see write_text) into a snapshot file
+inline std::istream &text_to_snapshot(std::istream &in, const std::string &path)
+{
+    Snapshot_writer w;
+    char ch;
+    while (in >> ch)
+    {
+        if (ch == 'U')
+            w.add(Core(in));
+        else
+            w.add(Grad(in));
+    }
+    w.write(path);
+    return in;
+}
+
+// write student i back out in the text format
+//   U name midterm final hw...
+//   G name midterm final thesis hw...
+inline std::ostream &write_text(std::ostream &os, const Roster_snapshot &s,
+                                Roster_snapshot::size_type i)
+{
+    os << (s.is_grad(i) ? 'G' : 'U') << ' ' << s.name(i) << ' '
+       << s.midterm_grade(i) << ' ' << s.final_grade(i);
+    if (s.is_grad(i))
+        os << ' ' << s.thesis_grade(i);
+    for (const double *p = s.hw_begin(i); p != s.hw_end(i); ++p)
+        os << ' ' << *p;
+    return os << '\n';
+}
+
+inline std::ostream &snapshot_to_text(std::ostream &os, const Roster_snapshot &s)
+{
+    // enough digits that reading the text back gives the same doubles
+    std::streamsize prec = os.precision(std::numeric_limits<double>::max_digits10);
+    for (Roster_snapshot::size_type i = 0; i != s.size(); ++i)
+        write_text(os, s, i);
+    os.precision(prec);
+    return os;
+}
+
+#endif
@@ -2,13 +2,23 @@
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include <string>
+#include <utility>
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
 
 using namespace std;  
 
 typedef vector<int> vi;
-typedef vector<vector<int>> vvi;
 
-int brute_force(vvi D, int N) {
+// N dice stored flat, row-major: face k of die j is D[6 * j + k]
+typedef vi dice;
+
+// try every ordering of the N dice, O(N! * N)
+// only usable for small N, kept to cross-check solve()
+int brute_force(const dice& D, int N) {
 
     int max_len = 0;
     int dec_num, inc_num;
@@ -23,24 +33,28 @@ int brute_force(vvi D, int N) {
                 int r = row[j];
                 // assign first value; 
                 if (j == 0) {
-                    dec_num = D[r][i];
-                    inc_num = D[r][i];
+                    dec_num = D[6 * r + i];
+                    inc_num = D[6 * r + i];
                     inc_len += 1; dec_len +=1;
                     continue;
                 }
                 // see if there is the next number in 
                 // sequence in this (row[j]-th) dice
+                // the two sequences are separate candidates, so the same
+                // die may extend both
                 for (int k = 0; k < 6; ++k) {
-                    if (dec_num == (D[r][k] + 1)) {
+                    if (dec_num == (D[6 * r + k] + 1)) {
                         dec_num -= 1;
                         dec_len += 1;
                         break;
-                    } else if (inc_num == (D[r][k] - 1)) {
+                    }
+                }
+                for (int k = 0; k < 6; ++k) {
+                    if (inc_num == (D[6 * r + k] - 1)) {
                         inc_num += 1;
                         inc_len += 1;
                         break;
                     }
-                    
                 }
             }
 
@@ -55,28 +69,206 @@ int brute_force(vvi D, int N) {
 }
 
 
-int main() {
+// longest straight by sliding window + incremental bipartite matching
+//
+// a straight v, v+1, ..., v+L-1 is possible iff every value in it can be
+// matched to a different die that shows it. walk the distinct values in
+// increasing order keeping a window [l, r] of consecutive values that are
+// all matched. to extend the window by value r, look for an augmenting
+// path from r (Kuhn's algorithm); if there is none, drop values from the
+// left, freeing their dice, until there is. each value enters and leaves
+// the window once.
+class Straight_solver {
+public:
+    Straight_solver(const dice& D, int N) : die_of_value(), value_of_die(N, -1), seen(N, 0), stamp(0) {
+        // (value, die) pairs sorted by value, a die showing a value twice counts once
+        vector<pair<int, int>> vd;
+        vd.reserve(6 * N);
+        for (int j = 0; j < N; ++j)
+            for (int k = 0; k < 6; ++k)
+                vd.push_back(make_pair(D[6 * j + k], j));
+        sort(vd.begin(), vd.end());
+        vd.erase(unique(vd.begin(), vd.end()), vd.end());
 
-    int T; 
-    cin >> T; 
-    // read in m x 6 matrix into D
-    for (int i = 0; i < T; ++i) {
-        int N;
-        cin >> N; 
+        // adjacency of value index i is dice[first[i], first[i+1])
+        for (size_t i = 0; i < vd.size(); ++i) {
+            if (i == 0 || vd[i].first != vd[i - 1].first) {
+                values.push_back(vd[i].first);
+                first.push_back(dice.size());
+            }
+            dice.push_back(vd[i].second);
+        }
+        first.push_back(dice.size());
+        die_of_value.assign(values.size(), -1);
+    }
+
+    int solve() {
+        int best = 0;
+        int l = 0;
+        for (int r = 0; r < (int)values.size(); ++r) {
+            // a gap in the values ends every straight through it
+            if (r > 0 && values[r] != values[r - 1] + 1) {
+                while (l < r) unmatch(l++);
+            }
+            while (!augment(r)) unmatch(l++);
+            best = max(best, r - l + 1);
+        }
+        return best;
+    }
+
+private:
+    void unmatch(int v) {
+        value_of_die[die_of_value[v]] = -1;
+        die_of_value[v] = -1;
+    }
+
+    // find a die for value v, moving other values to other dice if needed.
+    // depth-first over values with an explicit stack, so a long augmenting
+    // path can't overflow the call stack. a value that has a free die takes
+    // it without going deeper: otherwise a chain of dice that all show
+    // v+1 would be walked die by die before the free one is tried.
+    bool augment(int v) {
+        ++stamp;
+        if (take_free(v)) return true;
+
+        path.clear();
+        path.push_back(step{v, first[v], -1});
+        while (!path.empty()) {
+            step& s = path.back();
+            if (s.e == first[s.v + 1]) {
+                path.pop_back();
+                continue;
+            }
+            int d = dice[s.e++];
+            if (seen[d] == stamp) continue;
+            seen[d] = stamp;
 
-        vvi D;
-        D.resize(N);
-        for (int j = 0; j < N; ++j) {
-            D[j].resize(6);
+            // d is taken (take_free found no free die of s.v); try to move
+            // its value elsewhere
+            int w = value_of_die[d];
+            if (take_free(w)) {
+                // w moved to a free die: shift every value on the path
+                // onto the die it came through
+                for (size_t k = path.size(); k-- > 0; ) {
+                    value_of_die[d] = path[k].v;
+                    die_of_value[path[k].v] = d;
+                    d = path[k].via;
+                }
+                return true;
+            }
+            path.push_back(step{w, first[w], d});
         }
+        return false;
+    }
 
-        for (int j = 0; j < N; ++j) {
-            for (int k = 0; k < 6; ++k) {
-                cin >> D[j][k];
+    // match v to a die showing it that holds no value, if there is one
+    bool take_free(int v) {
+        for (int e = first[v]; e < first[v + 1]; ++e) {
+            int d = dice[e];
+            if (value_of_die[d] == -1) {
+                value_of_die[d] = v;
+                die_of_value[v] = d;
+                return true;
             }
         }
-        // find all ordering of N dies
-        cout << "Case #" << to_string(i) << ": " << to_string(brute_force(D, N)) << '\n';
+        return false;
+    }
+
+    // a value on the current search path: next edge to try, and the die
+    // that currently holds it (-1 for the value being matched)
+    struct step {
+        int v, e, via;
+    };
+
+    vi values;              // distinct values, sorted
+    vi first, dice;         // value index -> dice showing it
+    vi die_of_value;        // current matching, -1 if unmatched
+    vi value_of_die;
+    vi seen;                // die visited in the current augment if seen[d] == stamp
+    int stamp;
+    vector<step> path;      // augment's stack, kept to reuse its storage
+};
+
+int solve(const dice& D, int N) {
+    return Straight_solver(D, N).solve();
+}
+
+
+// reads non-negative and negative ints from all of a stream at once,
+// instead of one formatted extraction per number
+class Int_reader {
+public:
+    explicit Int_reader(FILE* f) : pos(0) {
+        char chunk[1 << 16];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof chunk, f)) > 0)
+            buf.append(chunk, n);
+    }
+
+    int next() {
+        while (pos < buf.size() && buf[pos] != '-' && (buf[pos] < '0' || buf[pos] > '9')) ++pos;
+        if (pos == buf.size()) throw runtime_error("unexpected end of input");
+        bool neg = buf[pos] == '-';
+        if (neg) ++pos;
+        int x = 0;
+        while (pos < buf.size() && buf[pos] >= '0' && buf[pos] <= '9')
+            x = 10 * x + (buf[pos++] - '0');
+        return neg ? -x : x;
+    }
+
+private:
+    string buf;
+    size_t pos;
+};
+
+
+struct test_case {
+    int N;
+    dice D;
+};
+
+
+// die6sided [check] [parallel] < input
+//   check:    also run brute_force on small cases and compare
+//   parallel: solve the cases on all cores, output stays in case order
+int main(int argc, char** argv) {
+    bool check = false, parallel = false;
+    for (int a = 1; a < argc; ++a) {
+        check = check || string(argv[a]) == "check";
+        parallel = parallel || string(argv[a]) == "parallel";
+    }
+
+    Int_reader in(stdin);
+    int T = in.next();
+
+    // read every N x 6 matrix up front, one allocation per case
+    vector<test_case> cases(T);
+    for (int i = 0; i < T; ++i) {
+        cases[i].N = in.next();
+        cases[i].D.resize(6 * cases[i].N);
+        for (int j = 0; j < 6 * cases[i].N; ++j)
+            cases[i].D[j] = in.next();
+    }
+
+    // cases are independent; each answer goes to its own slot
+    vi ans(T);
+    atomic<int> next_case(0);
+    auto work = [&]() {
+        for (int i; (i = next_case++) < T; )
+            ans[i] = solve(cases[i].D, cases[i].N);
+    };
+
+    unsigned nthreads = parallel ? max(1u, thread::hardware_concurrency()) : 1;
+    vector<thread> pool;
+    for (unsigned t = 1; t < nthreads; ++t)
+        pool.push_back(thread(work));
+    work();
+    for (auto& t : pool) t.join();
+
+    for (int i = 0; i < T; ++i) {
+        if (check && cases[i].N <= 8 && brute_force(cases[i].D, cases[i].N) != ans[i])
+            cerr << "Case #" << to_string(i) << ": brute_force gives " << brute_force(cases[i].D, cases[i].N) << '\n';
+        cout << "Case #" << to_string(i) << ": " << to_string(ans[i]) << '\n';
     }
 
 }
@@ -5,13 +5,15 @@
 #include <vector>
 #include <functional>
 
+#include "print_elements.h"
+
 using namespace std;
 
 namespace pair_ {
 
     template<typename T1, typename T2>
         ostream& operator<< (ostream& os, const pair<T1, T2>& p){
-            return os << "[" << p.first << ", " << p.second << "]" << endl;
+            return format_::write(os, p) << endl;
         }
 
     void print_pair(){
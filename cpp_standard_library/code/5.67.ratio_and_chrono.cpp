@@ -2,6 +2,8 @@
 #include <iostream>
 #include <chrono>
 
+#include "print_elements.h"
+
 
 using namespace std;
 
@@ -52,8 +54,7 @@ namespace chrono_ {
 
     template<typename V, typename R>
     ostream& operator<<(ostream& s, const chrono::duration<V, R>& d){
-        s << "[" << d.count() << " of" << R::num << "/" << R::den << "]";
-        return s;
+        return format_::write(s, d);
     }
 
     void print_duration(){
@@ -4,7 +4,10 @@
 #include <algorithm>
 #include <list>
 #include <deque>
+#include <iterator>
 
+#include "primes.h"
+#include "print_elements.h"
 
 using namespace std;
 
@@ -110,15 +113,6 @@ namespace algorithm_ {
 
     }
 
-    template<typename T>
-        void PRINT_ELEMENTS(const T& coll, const string& optstr = ""){
-            cout << optstr << ": ";
-            for(const auto& elem: coll){
-                cout << elem << " ";
-            }
-            cout << endl;
-        }
-
     int square (int value){
         return value*value;
     }
@@ -140,21 +134,8 @@ namespace algorithm_ {
         PRINT_ELEMENTS(coll2,"squared: ");
     }
 
-    bool isPrime (int number)
-    {
-        // ignore negative sign
-        number = abs(number);
-        // 0 and 1 are no prime numbers
-        if (number == 0 || number == 1) {
-            return false;
-        }
-        // find divisor that divides without a remainder
-        int divisor;
-        for (divisor = number/2; number%divisor != 0; --divisor) {
-        ; }
-        // if no divisor greater than 1 is found, it is a prime number
-        return divisor == 1;
-    }
+    // -- predicate object: sieve lookup below 1000, Miller-Rabin above
+    const primes_::prime_predicate isPrime(1000);
 
     void predicate_in_algo(){
         list<int> coll;
@@ -0,0 +1,258 @@
+#ifndef PRIMES_H
+#define PRIMES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// primality for single numbers and for ranges.
+//
+// is_prime: deterministic Miller-Rabin, correct for every 64-bit number
+// (the 7 bases below have no strong pseudoprime under 2^64).
+//
+// for_each_prime / count_primes / primes_in: segmented sieve of
+// Eratosthenes. numbers are stored on a mod 30 wheel, one byte per 30
+// numbers with a bit for each of the 8 residues coprime to 30, so
+// multiples of 2, 3 and 5 take no space and are never crossed off. the
+// range is sieved in segments that fit in L1 cache, each sieving prime
+// carrying its next multiple from one segment to the next. the sieving
+// primes up to sqrt(hi) come from the same sieve. a range that is short
+// next to sqrt(hi) is not sieved: each number on the wheel goes to
+// is_prime instead, which is cheaper than finding the sieving primes.
+// ranges must end below 2^63.
+//
+// prime_predicate: is_prime as a function object for find_if and friends,
+// optionally answering numbers below a limit from a precomputed sieve.
+
+namespace primes_ {
+
+    using namespace std;
+
+    inline uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t m){
+        return (unsigned __int128)a * b % m;
+    }
+
+    inline uint64_t pow_mod(uint64_t a, uint64_t e, uint64_t m){
+        uint64_t r = 1;
+        for (; e; e >>= 1) {
+            if (e & 1) r = mul_mod(r, a, m);
+            a = mul_mod(a, a, m);
+        }
+        return r;
+    }
+
+    inline bool is_prime(uint64_t n){
+        if (n < 2) return false;
+        for (uint64_t p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 }) {
+            if (n % p == 0) return n == p;
+        }
+        if (n < 41 * 41) return true;
+
+        // n - 1 = d * 2^s with d odd
+        uint64_t d = n - 1;
+        int s = __builtin_ctzll(d);
+        d >>= s;
+        for (uint64_t a : { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 }) {
+            a %= n;
+            if (a == 0) continue;
+            uint64_t x = pow_mod(a, d, n);
+            if (x == 1 || x == n - 1) continue;
+            int r = 1;
+            for (; r < s; ++r) {
+                x = mul_mod(x, x, n);
+                if (x == n - 1) break;
+            }
+            if (r == s) return false;       // a witnesses that n is composite
+        }
+        return true;
+    }
+
+    // smallest prime >= n, 0 if there is none below 2^64
+    inline uint64_t next_prime(uint64_t n){
+        if (n <= 2) return 2;
+        // the largest 64-bit prime; past it the search would wrap around
+        if (n > 18446744073709551557ull) return 0;
+        for (n |= 1; !is_prime(n); n += 2) {}
+        return n;
+    }
+
+    // -- the mod 30 wheel
+
+    // bit i of a byte stands for 30k + residues[i]
+    constexpr uint8_t residues[8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+    // distance from residues[i] to the next one
+    constexpr uint8_t gaps[8] = { 6, 4, 2, 4, 2, 4, 6, 2 };
+    // bit of n % 30, 0 if n has a factor 2, 3 or 5
+    constexpr uint8_t bit_of[30] = {
+        0, 1 << 0, 0, 0, 0, 0, 0, 1 << 1, 0, 0, 0, 1 << 2, 0, 1 << 3, 0,
+        0, 0, 1 << 4, 0, 1 << 5, 0, 0, 0, 1 << 6, 0, 0, 0, 0, 0, 1 << 7
+    };
+
+    inline uint64_t isqrt(uint64_t n){
+        uint64_t r = sqrtl(n);
+        while (r * r > n) --r;
+        while ((r + 1) * (r + 1) <= n) ++r;
+        return r;
+    }
+
+    // a prime p >= 7 with the multiple p * q to cross off next, q running
+    // over the wheel from p on. p <= sqrt(2^63) fits in 32 bits
+    struct sieving_prime { uint64_t multiple; uint32_t p, wheel; };
+
+    template<typename F> void sieve_segments(uint64_t lo, uint64_t hi, F segment);
+
+    // the primes 7 <= p <= limit, from a sieve of [7, limit], each set to
+    // start crossing off at its first multiple on the wheel that is both
+    // >= base and >= p * p
+    inline vector<sieving_prime> sieving_primes(uint64_t limit, uint64_t base){
+        vector<sieving_prime> sp;
+        if (limit < 7) return sp;
+        // pi(x) < 1.26 x / ln x
+        sp.reserve(1.26 * limit / log(double(limit)));
+        sieve_segments(7, limit + 1, [&](const uint8_t* bytes, uint64_t b, size_t n){
+            for (size_t k = 0; k < n; ++k) {
+                for (unsigned bits = bytes[k]; bits; bits &= bits - 1) {
+                    uint64_t p = b + 30 * k + residues[__builtin_ctz(bits)];
+                    // first q >= max(p, base / p) on the wheel
+                    uint64_t q = max<uint64_t>(p, (base + p - 1) / p);
+                    uint64_t m = q / 30 * 30;
+                    uint32_t w = 0;
+                    while (m + residues[w] < q) {
+                        if (++w == 8) { w = 0; m += 30; }
+                    }
+                    sp.push_back({ p * (m + residues[w]), uint32_t(p), w });
+                }
+            }
+        });
+        return sp;
+    }
+
+    // sieve [lo, hi) and call segment(bytes, base, nbytes) for each block:
+    // bit i of bytes[k] is set iff base + 30k + residues[i] is a prime in
+    // [lo, hi). 2, 3 and 5 have no bit and are left to the caller.
+    template<typename F>
+        void sieve_segments(uint64_t lo, uint64_t hi, F segment){
+            if (hi <= lo) return;
+            const size_t segment_bytes = 32 * 1024;
+            uint64_t base = lo / 30 * 30;
+
+            // each sieving prime costs about 70ns to find and set up and
+            // 3ns a segment to visit; is_prime costs about 190ns a number
+            // of the range. the segmented sieve wins by far on ranges as
+            // long as sqrt(hi), is_prime on short ranges far from 0
+            const uint64_t limit = isqrt(hi - 1);
+            const double sieving = limit < 7 ? 0 : limit / log(double(limit)),
+                         segments = (hi - lo) / (30.0 * segment_bytes) + 1;
+            const bool test_each = (hi - lo) * 64.0 < sieving * (24 + segments);
+            vector<sieving_prime> sp;
+            if (!test_each) sp = sieving_primes(limit, base);
+
+            vector<uint8_t> bytes(segment_bytes);
+            for (; base < hi; base += 30 * segment_bytes) {
+                uint64_t end = min<uint64_t>(hi, base + 30 * segment_bytes);
+                size_t n = (end - base + 29) / 30;
+
+                if (test_each) {
+                    for (size_t k = 0; k < n; ++k) {
+                        uint8_t b = 0;
+                        for (int i = 0; i < 8; ++i) b |= is_prime(base + 30 * k + residues[i]) << i;
+                        bytes[k] = b;
+                    }
+                } else {
+                    memset(bytes.data(), 0xFF, n);
+                    for (sieving_prime& s : sp) {
+                        uint64_t m = s.multiple;
+                        uint32_t w = s.wheel;
+                        for (; m < end; w = (w + 1) & 7) {
+                            uint64_t off = m - base;
+                            bytes[off / 30] &= ~bit_of[off % 30];
+                            m += uint64_t(s.p) * gaps[w];
+                        }
+                        s.multiple = m;
+                        s.wheel = w;
+                    }
+                }
+
+                // 1 is not prime; bits outside [lo, hi) in the end bytes
+                if (base == 0) bytes[0] &= ~1;
+                for (int i = 0; i < 8; ++i) {
+                    if (base + residues[i] < lo) bytes[0] &= ~(1 << i);
+                    if (base + 30 * (n - 1) + residues[i] >= end) bytes[n - 1] &= ~(1 << i);
+                }
+                segment(bytes.data(), base, n);
+            }
+        }
+
+    // f(p) for every prime p in [lo, hi), increasing
+    template<typename F>
+        void for_each_prime(uint64_t lo, uint64_t hi, F f){
+            for (uint64_t p : { 2, 3, 5 }) {
+                if (lo <= p && p < hi) f(p);
+            }
+            sieve_segments(lo, hi, [&](const uint8_t* bytes, uint64_t base, size_t n){
+                for (size_t k = 0; k < n; ++k) {
+                    for (unsigned b = bytes[k]; b; b &= b - 1) {
+                        f(base + 30 * k + residues[__builtin_ctz(b)]);
+                    }
+                }
+            });
+        }
+
+    inline uint64_t count_primes(uint64_t lo, uint64_t hi){
+        uint64_t ret = 0;
+        for (uint64_t p : { 2, 3, 5 }) {
+            ret += lo <= p && p < hi;
+        }
+        sieve_segments(lo, hi, [&](const uint8_t* bytes, uint64_t, size_t n){
+            for (size_t k = 0; k < n; ++k) ret += __builtin_popcount(bytes[k]);
+        });
+        return ret;
+    }
+
+    inline vector<uint64_t> primes_in(uint64_t lo, uint64_t hi){
+        vector<uint64_t> ret;
+        for_each_prime(lo, hi, [&](uint64_t p){ ret.push_back(p); });
+        return ret;
+    }
+
+    // is_prime as a predicate on any integer type; a negative number is
+    // prime if its absolute value is. with a limit, numbers below it are
+    // looked up in a wheel-packed sieve (limit / 30 bytes, built once and
+    // shared by the copies that algorithms make of a predicate); numbers
+    // above it go to Miller-Rabin.
+    class prime_predicate {
+        public:
+            prime_predicate() : limit(0) {}
+
+            explicit prime_predicate(uint64_t limit) : limit(limit){
+                auto t = make_shared<vector<uint8_t>>((limit + 29) / 30);
+                sieve_segments(0, limit, [&](const uint8_t* bytes, uint64_t base, size_t n){
+                    memcpy(t->data() + base / 30, bytes, n);
+                });
+                table = t;
+            }
+
+            template<typename T>
+                bool operator()(T number) const {
+                    static_assert(is_integral<T>::value, "prime_predicate takes integers");
+                    uint64_t n = number;
+                    if constexpr (is_signed<T>::value) {
+                        if (number < 0) n = -n;
+                    }
+                    if (n >= limit) return is_prime(n);
+                    // bit p set for the primes below 30
+                    if (n < 30) return 0x208A28AC >> n & 1;
+                    return (*table)[n / 30] & bit_of[n % 30];
+                }
+
+        private:
+            shared_ptr<const vector<uint8_t>> table;
+            uint64_t limit;
+    };
+}
+
+#endif // PRIMES_H
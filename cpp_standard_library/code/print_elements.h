@@ -0,0 +1,264 @@
+#ifndef PRINT_ELEMENTS_H
+#define PRINT_ELEMENTS_H
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// formatted output of containers and of pairs, tuples and durations
+// without going through operator<< for every element: numbers are
+// converted with to_chars into a local buffer that is handed to the
+// stream in big blocks. containers that keep arithmetic elements in one
+// array (vector, array, built-in arrays) are detected at compile time and
+// formatted by a loop over the raw pointer.
+//
+// formats: pair and tuple "[a, b, c]", duration "[count of num/den]",
+// nested containers "[x y z]". integers print as with <<, floating point
+// in the shortest form that reads back to the same value (so 0.1 is "0.1"
+// but pi gets all its digits, not 6). characters of any width print as
+// characters, wide ones encoded as UTF-8.
+//
+// to_chars knows nothing of the stream's state, so if the stream has
+// anything but the default flags, precision and width (hex, fixed,
+// setprecision, boolalpha, setw, ...), numbers and bools go through <<
+// one at a time instead and come out as the stream says.
+
+namespace format_ {
+
+    using namespace std;
+
+    template<typename T> struct is_pair : false_type {};
+    template<typename A, typename B> struct is_pair<pair<A, B>> : true_type {};
+
+    template<typename T> struct is_tuple : false_type {};
+    template<typename... Ts> struct is_tuple<tuple<Ts...>> : true_type {};
+
+    template<typename T> struct is_duration : false_type {};
+    template<typename V, typename R> struct is_duration<chrono::duration<V, R>> : true_type {};
+
+    template<typename T>
+        constexpr bool is_character = is_same<T, char>::value || is_same<T, signed char>::value
+                                      || is_same<T, unsigned char>::value || is_same<T, wchar_t>::value
+#ifdef __cpp_char8_t
+                                      || is_same<T, char8_t>::value
+#endif
+                                      || is_same<T, char16_t>::value || is_same<T, char32_t>::value;
+
+    // numbers to_chars can format; bool and characters print as themselves
+    template<typename T>
+        constexpr bool is_number = is_arithmetic<T>::value
+                                   && !is_same<T, bool>::value && !is_character<T>;
+
+    template<typename T, typename = void> struct is_range : false_type {};
+    template<typename T>
+        struct is_range<T, void_t<decltype(begin(declval<const T&>())),
+                                  decltype(end(declval<const T&>()))>> : true_type {};
+
+    // data() gives a pointer to size() numbers stored one after another
+    template<typename T, typename = void> struct is_contiguous_numbers : false_type {};
+    template<typename T>
+        struct is_contiguous_numbers<T, void_t<decltype(size(declval<const T&>())),
+                                               decltype(data(declval<const T&>()))>>
+            : integral_constant<bool,
+                  is_pointer<decltype(data(declval<const T&>()))>::value
+                  && is_number<remove_cv_t<remove_pointer_t<decltype(data(declval<const T&>()))>>>> {};
+
+    // collects output in a fixed buffer and writes it to the stream when
+    // full or when destroyed
+    class buffered_writer {
+        public:
+            explicit buffered_writer(ostream& os)
+                : os(os), n(0),
+                  plain(os.flags() == (ios_base::dec | ios_base::skipws)
+                        && os.precision() == 6 && os.width() == 0) {}
+            ~buffered_writer() { flush(); }
+
+            buffered_writer(const buffered_writer&) = delete;
+            buffered_writer& operator=(const buffered_writer&) = delete;
+
+            // room for k more chars (k <= capacity); fill it, then commit
+            char* reserve(size_t k){
+                if (n + k > capacity) flush();
+                return buf + n;
+            }
+            void commit(char* end){ n = end - buf; }
+
+            void put(char c){ *reserve(1) = c; ++n; }
+
+            void put(string_view s){
+                if (s.size() > capacity / 2) {
+                    flush();
+                    os.write(s.data(), s.size());
+                    return;
+                }
+                char* p = reserve(s.size());
+                memcpy(p, s.data(), s.size());
+                n += s.size();
+            }
+
+            template<typename T>
+                void number(T x){
+                    if (!plain) {
+                        stream() << x;
+                        return;
+                    }
+                    char* p = reserve(max_number);
+                    commit(to_chars(p, p + max_number, x).ptr);
+                }
+
+            // code point c as UTF-8
+            void character(char32_t c){
+                char* p = reserve(4);
+                if (c < 0x80) {
+                    *p++ = char(c);
+                } else if (c < 0x800) {
+                    *p++ = char(0xC0 | c >> 6);
+                    *p++ = char(0x80 | (c & 0x3F));
+                } else if (c < 0x10000) {
+                    *p++ = char(0xE0 | c >> 12);
+                    *p++ = char(0x80 | (c >> 6 & 0x3F));
+                    *p++ = char(0x80 | (c & 0x3F));
+                } else {
+                    *p++ = char(0xF0 | (c >> 18 & 0x07));
+                    *p++ = char(0x80 | (c >> 12 & 0x3F));
+                    *p++ = char(0x80 | (c >> 6 & 0x3F));
+                    *p++ = char(0x80 | (c & 0x3F));
+                }
+                commit(p);
+            }
+
+            // the stream is in its default state, so to_chars output is
+            // what << would give for integers
+            bool is_plain() const { return plain; }
+
+            void flush(){
+                os.write(buf, n);
+                n = 0;
+            }
+
+            ostream& stream(){ flush(); return os; }
+
+            // longest to_chars output: 20 digits and a sign for integers,
+            // 24 chars for the shortest form of a double; long double more
+            static const size_t max_number = 64;
+
+        private:
+            static const size_t capacity = 8192;
+            ostream& os;
+            char buf[capacity];
+            size_t n;
+            const bool plain;
+    };
+
+    template<typename T> void write(buffered_writer& w, const T& x);
+
+    // elements of coll, each followed by sep
+    template<typename C>
+        void write_elements(buffered_writer& w, const C& coll, char sep){
+            if constexpr (is_contiguous_numbers<C>::value) {
+                if (!w.is_plain()) {
+                    for (const auto& elem : coll) {
+                        w.number(elem);
+                        w.put(sep);
+                    }
+                    return;
+                }
+                const auto* p = data(coll);
+                size_t n = size(coll);
+                for (size_t i = 0; i < n; ++i) {
+                    char* b = w.reserve(buffered_writer::max_number + 1);
+                    b = to_chars(b, b + buffered_writer::max_number, p[i]).ptr;
+                    *b++ = sep;
+                    w.commit(b);
+                }
+            } else {
+                for (const auto& elem : coll) {
+                    write(w, elem);
+                    w.put(sep);
+                }
+            }
+        }
+
+    template<typename Tuple, size_t... I>
+        void write_tuple(buffered_writer& w, const Tuple& t, index_sequence<I...>){
+            w.put('[');
+            ((w.put(I == 0 ? "" : ", "), write(w, get<I>(t))), ...);
+            w.put(']');
+        }
+
+    template<typename T>
+        void write(buffered_writer& w, const T& x){
+            if constexpr (is_same<T, bool>::value) {
+                if (w.is_plain()) w.put(char('0' + x));
+                else w.stream() << x;
+            } else if constexpr (sizeof(T) == 1 && is_character<T>) {
+                // bytes as they are, like << does for the char types
+                w.put(char(x));
+            } else if constexpr (is_character<T>) {
+                w.character(char32_t(x));
+            } else if constexpr (is_number<T>) {
+                w.number(x);
+            } else if constexpr (is_convertible<const T&, string_view>::value) {
+                w.put(string_view(x));
+            } else if constexpr (is_pair<T>::value) {
+                w.put('[');
+                write(w, x.first);
+                w.put(", ");
+                write(w, x.second);
+                w.put(']');
+            } else if constexpr (is_tuple<T>::value) {
+                write_tuple(w, x, make_index_sequence<tuple_size<T>::value>());
+            } else if constexpr (is_duration<T>::value) {
+                using R = typename T::period;
+                w.put('[');
+                write(w, x.count());
+                w.put(" of ");
+                w.number(R::num);
+                w.put('/');
+                w.number(R::den);
+                w.put(']');
+            } else if constexpr (is_range<T>::value) {
+                w.put('[');
+                bool first = true;
+                for (const auto& elem : x) {
+                    if (!first) w.put(' ');
+                    write(w, elem);
+                    first = false;
+                }
+                w.put(']');
+            } else {
+                // anything else goes through its own operator<<
+                w.stream() << x;
+            }
+        }
+
+    // write x to os in the formats above
+    template<typename T>
+        ostream& write(ostream& os, const T& x){
+            buffered_writer w(os);
+            write(w, x);
+            return os;
+        }
+}
+
+// optstr, then every element of coll followed by a space
+template<typename T>
+    void PRINT_ELEMENTS(const T& coll, const std::string& optstr = ""){
+        {
+            format_::buffered_writer w(std::cout);
+            w.put(optstr);
+            w.put(": ");
+            format_::write_elements(w, coll, ' ');
+            w.put('\n');
+        }
+        std::cout.flush();
+    }
+
+#endif // PRINT_ELEMENTS_H
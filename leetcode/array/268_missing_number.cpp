@@ -1,4 +1,12 @@
 #include "includes.h"
+#include "flat_hash.h"
+#include "bitset.h"
+
+#include <cstdint>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 
 // solution 1: by sorting
@@ -19,12 +27,12 @@ int missingNumber1(vector<int>& nums)
     return -1;
 }
 
-// solution 2: with unorderd_set 
+// solution 2: with a hash set (flat_hash_set: one array, no node per element)
 // time: O(n) amortized 
 // space: O(n) 
 int missingNumber2(vector<int>& nums) 
 {
-    unordered_set<int> S(nums.begin(), nums.end());
+    flat_hash_set<int> S(nums.begin(), nums.end());
     for(int i = 0; i < nums.size() + 1; ++i) {
         if(S.find(i) == S.end()) return i;
     }
@@ -47,4 +55,203 @@ int missingNumber3(vector<int>& nums)
         missing ^= (i^nums[i]);
     }
     return missing;
-}
\ No newline at end of file
+}
+
+// solution 3 spends most of its time on i^nums[i], but xor is associative:
+// missing = n ^ (0^1^...^(n-1)) ^ (nums[0]^...^nums[n-1])
+// the index part has a closed form, which leaves a plain reduction over
+// nums that vectorizes, splits across threads, or can be swapped for a sum
+
+// 0^1^...^k repeats with period 4
+static unsigned xorUpTo(unsigned k)
+{
+    switch (k & 3) {
+        case 0:  return k;
+        case 1:  return 1;
+        case 2:  return k + 1;
+        default: return 0;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// xor of [p, p+n), 8 ints per step with AVX2
+__attribute__((target("avx2")))
+static unsigned xorReduceAVX2(const int* p, size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm256_xor_si256(acc, _mm256_loadu_si256((const __m256i*)(p + i)));
+    __m128i x = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    x = _mm_xor_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_xor_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    unsigned r = _mm_cvtsi128_si32(x);
+    for (; i < n; ++i) r ^= p[i];
+    return r;
+}
+
+#ifdef __SSE2__
+// same with SSE2, which every x86-64 has
+static unsigned xorReduceSSE2(const int* p, size_t n)
+{
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_xor_si128(acc0, _mm_loadu_si128((const __m128i*)(p + i)));
+        acc1 = _mm_xor_si128(acc1, _mm_loadu_si128((const __m128i*)(p + i + 4)));
+    }
+    __m128i x = _mm_xor_si128(acc0, acc1);
+    x = _mm_xor_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_xor_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    unsigned r = _mm_cvtsi128_si32(x);
+    for (; i < n; ++i) r ^= p[i];
+    return r;
+}
+
+#endif // __SSE2__
+#endif // x86
+
+static unsigned xorReduce(const int* p, size_t n)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) return xorReduceAVX2(p, n);
+#endif
+#ifdef __SSE2__
+    return xorReduceSSE2(p, n);
+#else
+    unsigned r = 0;
+    for (size_t i = 0; i < n; ++i) r ^= p[i];  // left to the compiler's vectorizer
+    return r;
+#endif
+}
+
+// solution 4: solution 3 as a vector reduction
+// time: O(n), 8 elements per instruction
+// space: O(1)
+int missingNumber4(const vector<int>& nums)
+{
+    unsigned n = nums.size();
+    if (n == 0) return 0;
+    return n ^ xorUpTo(n - 1) ^ xorReduce(nums.data(), n);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// sum of [p, p+n) modulo 2^32
+__attribute__((target("avx2")))
+static unsigned sumReduceAVX2(const int* p, size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i*)(p + i)));
+    __m128i x = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    unsigned r = _mm_cvtsi128_si32(x);
+    for (; i < n; ++i) r += p[i];
+    return r;
+}
+
+#endif // x86
+
+static unsigned sumReduce(const int* p, size_t n)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) return sumReduceAVX2(p, n);
+#endif
+    unsigned r = 0;
+    for (size_t i = 0; i < n; ++i) r += p[i];   // the compiler vectorizes this with SSE2
+    return r;
+}
+
+// solution 5: gauss, missing = n(n+1)/2 - sum(nums)
+// the answer is below 2^32, so the sums can wrap around mod 2^32 and
+// stay in 32-bit lanes
+// time: O(n)
+// space: O(1)
+int missingNumber5(vector<int>& nums)
+{
+    unsigned n = nums.size();
+    unsigned long long total = (unsigned long long)n * (n + 1) / 2;
+    return (unsigned)total - sumReduce(nums.data(), n);
+}
+
+// solution 6: mark every value in a bitset, the answer is its first
+// clear bit; find-first-zero skips whole words of present values
+// time: O(n)
+// space: O(n / 64) words
+int missingNumber6(vector<int>& nums)
+{
+    DynamicBitset seen(nums.size() + 1);
+    for (int x : nums) seen.set(x);
+    return seen.findFirstZero();
+}
+
+// solution 7: solution 4 split over threads, each xor-ing a chunk,
+// for arrays big enough to be memory bound on one core
+// time: O(n / threads)
+// space: O(threads)
+int missingNumberParallel(const vector<int>& nums, unsigned nthreads)
+{
+    unsigned n = nums.size();
+    if (n == 0) return 0;
+    // below a few million ints the threads cost more than they save
+    nthreads = min(nthreads, n / (1u << 20));
+    if (nthreads <= 1) return missingNumber4(nums);
+
+    vector<unsigned> part(nthreads);
+    vector<thread> pool;
+    for (unsigned t = 0; t < nthreads; ++t) {
+        size_t b = (size_t)n * t / nthreads, e = (size_t)n * (t + 1) / nthreads;
+        pool.emplace_back([&, t, b, e] { part[t] = xorReduce(nums.data() + b, e - b); });
+    }
+    unsigned r = n ^ xorUpTo(n - 1);
+    for (unsigned t = 0; t < nthreads; ++t) {
+        pool[t].join();
+        r ^= part[t];
+    }
+    return r;
+}
+
+// generalization: ids are distinct values from [0, universe), report every
+// value that is not there as [first, last] runs. one bit per possible id,
+// so a billion-id space needs 125MB, then the scans jump from one
+// present/missing boundary to the next, skipping whole 64-bit words.
+// time: O(n + universe / 64 + gaps)
+// space: O(universe / 64) words
+vector<pair<int, int>> missingRanges(const vector<int>& ids, int universe)
+{
+    DynamicBitset present(universe);
+    for (int id : ids) present.set(id);
+
+    vector<pair<int, int>> gaps;
+    for (size_t b = present.findFirstZero(); b != DynamicBitset::npos; ) {
+        size_t e = present.findNext(b);
+        if (e == DynamicBitset::npos) e = universe;
+        gaps.push_back({ (int)b, (int)(e - 1) });
+        b = present.findNextZero(e);
+    }
+    return gaps;
+}
+
+// same for a sparse universe: a roaring bitmap of the ids costs about two
+// bytes per id however large the universe is, and hands the ids back in
+// order, so the gaps are what lies between neighbours
+// time: O(n log(n / 65536 + 1) + universe / 65536)
+// space: O(n)
+vector<pair<int, int>> missingRanges2(const vector<int>& ids, int universe)
+{
+    RoaringBitmap present;
+    for (int id : ids) present.add(id);
+
+    vector<pair<int, int>> gaps;
+    long long next = 0;         // smallest id not yet accounted for
+    present.forEach([&](uint32_t id) {
+        if (id > next) gaps.push_back({ (int)next, (int)id - 1 });
+        next = (long long)id + 1;
+    });
+    if (next < universe) gaps.push_back({ (int)next, universe - 1 });
+    return gaps;
+}
@@ -1,4 +1,5 @@
 #include "includes.h"
+#include "compact.h"
 
 
 /*
@@ -37,4 +38,22 @@ int removeDuplicates(vector<int>& nums) {
     }
     
     return l+1;
-}
\ No newline at end of file
+}
+
+// same without the branch, 8 elements at a time: compare each element with
+// its predecessor (the block shifted by one lane) and left-pack the ones
+// that differ (see compact.h)
+// time: O(n)
+// space: O(1)
+int removeDuplicates2(vector<int>& nums) {
+    return compactUnique(nums.data(), nums.size(), nums.empty() ? 0 : nums[0] ^ 1);
+}
+
+// removeDuplicates2 on chunks in parallel; each chunk compares its first
+// element with the last one of the chunk before, then the kept parts are
+// moved together using the prefix sum of their lengths
+// time: O(n / threads + kept)
+// space: O(threads)
+int removeDuplicatesParallel(vector<int>& nums, unsigned nthreads) {
+    return compactParallel(nums.data(), nums.size(), nthreads, compactUnique);
+}
@@ -1,3 +1,6 @@
+#include "includes.h"
+#include "compact.h"
+
 
 /* 
     https://leetcode.com/problems/remove-element/description/
@@ -49,4 +52,21 @@ int removeElement2(vector<int>& nums, int val) {
     }
     return i;
 }
-    
\ No newline at end of file
+
+// solution 3: solution 2 without the branch, 8 elements at a time
+// compare against val into a mask, then left-pack the survivors with a
+// table-driven permute (see compact.h)
+// time: O(n)
+// space: O(1)
+int removeElement3(vector<int>& nums, int val) {
+    return compactNotEqual(nums.data(), nums.size(), val);
+}
+
+// solution 4: solution 3 on chunks in parallel, then the kept parts are
+// moved together using the prefix sum of their lengths
+// time: O(n / threads + kept)
+// space: O(threads)
+int removeElementParallel(vector<int>& nums, int val, unsigned nthreads) {
+    return compactParallel(nums.data(), nums.size(), nthreads,
+                           [val](int* p, size_t n, int) { return compactNotEqual(p, n, val); });
+}
@@ -1,4 +1,5 @@
 #include "includes.h"
+#include "matrix.h"
 
 
 // inplace 
@@ -21,4 +22,16 @@ vector<vector<int>> matrixReshape(vector<vector<int>>& nums, int r, int c)
         }
     }
     return out;
-}
\ No newline at end of file
+}
+
+// solution 2: keep the matrix in one row-major block (Matrix, see
+// matrix.h); row-major order is the same for every shape, so a reshape
+// only changes the dimensions and the result shares (and writes through
+// to) the input's storage, so nums is not const.
+// Matrix<int>::fromJagged converts leetcode's input with a single copy.
+// time O(1)
+// space O(1)
+Matrix<int> matrixReshape2(Matrix<int>& nums, int r, int c)
+{
+    return nums.reshape(r, c);
+}
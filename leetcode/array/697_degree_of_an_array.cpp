@@ -1,4 +1,6 @@
 #include "includes.h"
+#include "flat_hash.h"
+#include "degree.h"
 
 /* 
     Given a non-empty array of non-negative integers nums, the degree of this array is defined as the maximum frequency of any one of its elements.
@@ -10,7 +12,7 @@
 // 1. Computes frequency/occurrences of each int in vector
 // 2. Computes the shortest range of ints with highest frequency/occurrences
 int findShortestSubArray(vector<int>& nums) {
-    unordered_map<int, vector<int>> freq;     // <value of element, index of occurrences>
+    flat_hash_map<int, vector<int>> freq;     // <value of element, index of occurrences>
     for(int i = 0; i < nums.size(); ++i)
         freq[nums[i]].push_back(i);
     
@@ -24,4 +26,31 @@ int findShortestSubArray(vector<int>& nums) {
             shortest_len = min(shortest_len, it->second.back() - it->second.front() + 1);
     }
     return shortest_len;
-}
\ No newline at end of file
+}
+
+// solution 2: one pass, keeping only first index and count per value in an
+// open-addressing table (DegreeTracker, see degree.h). a value's last index
+// is the one being looked at, so its span is checked as its count goes up.
+// time: O(n)
+// space: O(distinct values), no per-occurrence lists
+int findShortestSubArray2(vector<int>& nums) {
+    DegreeTracker<FlatSlotTable> t;
+    t.push(nums.begin(), nums.end());
+    return t.shortest();
+}
+
+// solution 3: like solution 2, but when the values span a range not much
+// bigger than the array (leetcode's are 0..49999) index an array by value
+// instead of hashing. finding the range is a cheap extra scan.
+// time: O(n)
+// space: O(max - min)
+int findShortestSubArray3(vector<int>& nums) {
+    if (nums.empty()) return 0;
+    auto range = minmax_element(nums.begin(), nums.end());
+    long long lo = *range.first, hi = *range.second;
+    if (hi - lo >= 4 * (long long)nums.size() + 65536) return findShortestSubArray2(nums);
+
+    DegreeTracker<DenseSlotTable> t(DenseSlotTable(lo, hi));
+    t.push(nums.begin(), nums.end());
+    return t.shortest();
+}
@@ -1,4 +1,5 @@
 #include "includes.h"
+#include "merge.h"
 
 // https://leetcode.com/problems/merge-sorted-array/description/
 
@@ -24,4 +25,53 @@ void merge(vector<int>& nums1, int m, vector<int>& nums2, int n) {
 }
 
 // time O(m+n) linear complexity
-// space inplace, no space overhead
\ No newline at end of file
+// space inplace, no space overhead
+
+// solution 2: same backward merge, but the pick is a select instead of a
+// branch, so random input costs no mispredictions
+// time O(m+n)
+// space inplace
+void merge2(vector<int>& nums1, int m, vector<int>& nums2, int n) {
+    int i1 = m-1, i2 = n-1, k = m+n-1;
+    while (i1 >= 0 && i2 >= 0) {
+        bool take1 = nums1[i1] > nums2[i2];
+        nums1[k--] = take1 ? nums1[i1] : nums2[i2];
+        i1 -= take1;
+        i2 -= !take1;
+    }
+    while (i2 >= 0) nums1[k--] = nums2[i2--];
+}
+
+// solution 3: forward merge, 8 elements at a time through a bitonic
+// network (mergeSIMD, see merge.h). a forward merge can't run in place,
+// so the first m elements of nums1 are copied out first.
+// time O(m+n)
+// space O(m)
+void merge3(vector<int>& nums1, int m, vector<int>& nums2, int n) {
+    vector<int> head(nums1.begin(), nums1.begin() + m);
+    mergeSIMD(head.data(), m, nums2.data(), n, nums1.data());
+}
+
+// solution 4: solution 3 cut along merge-path diagonals so that each
+// thread merges an independent piece of the output
+// time O((m+n)/threads)
+// space O(m)
+void mergeParallel(vector<int>& nums1, int m, vector<int>& nums2, int n, unsigned nthreads) {
+    vector<int> head(nums1.begin(), nums1.begin() + m);
+    mergeParallel(head.data(), m, nums2.data(), n, nums1.data(), nthreads);
+}
+
+// generalization: merge k sorted arrays with a loser tree (see merge.h)
+// time O(N log k) for N elements in total
+// space O(k) besides the output
+vector<int> mergeKSorted(const vector<vector<int>>& runs) {
+    vector<pair<const int*, const int*>> ranges;
+    size_t total = 0;
+    for (const auto& r : runs) {
+        ranges.push_back({ r.data(), r.data() + r.size() });
+        total += r.size();
+    }
+    vector<int> out(total);
+    mergeK(ranges, out.data());
+    return out;
+}
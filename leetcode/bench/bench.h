@@ -0,0 +1,116 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+
+#include "includes.h"
+
+// benchmark harness: input generators, timing and allocation counting.
+// replaces the global operator new/delete, so include it from exactly one
+// file per benchmark executable.
+
+namespace bench {
+
+// allocations made since the counters were last reset
+size_t allocs = 0;
+size_t alloc_bytes = 0;
+
+enum class Dist { sorted, random, dups };
+
+const char* dist_name(Dist d)
+{
+    switch (d) {
+        case Dist::sorted: return "sorted";
+        case Dist::random: return "random";
+        default:           return "dups";
+    }
+}
+
+// 1e3, 1e4, ... up to max_n
+vector<size_t> sizes(size_t max_n)
+{
+    vector<size_t> ret;
+    for (size_t n = 1000; n <= max_n; n *= 10)
+        ret.push_back(n);
+    return ret;
+}
+
+// n values with the given distribution:
+//   sorted: 0, 1, 2, ...   random: uniform over [0, n)   dups: uniform over [0, 8)
+vector<int> make_values(Dist d, size_t n, unsigned seed = 1)
+{
+    vector<int> v(n);
+    mt19937 gen(seed);
+    if (d == Dist::sorted) {
+        for (size_t i = 0; i < n; ++i) v[i] = i;
+    } else {
+        uniform_int_distribution<int> val(0, d == Dist::dups ? 7 : (int)n - 1);
+        for (auto& x : v) x = val(gen);
+    }
+    return v;
+}
+
+struct Result {
+    double ns_per_elem;
+    double allocs;        // per call
+    double bytes;         // per call
+};
+
+// time run(input) on a fresh input from setup() each repetition, so that
+// in-place algorithms never see their own output. setup is not timed and
+// its allocations are not counted.
+template<class Setup, class Run>
+Result measure(size_t n, Setup setup, Run run, size_t min_elems = 20000000)
+{
+    size_t reps = max<size_t>(1, min<size_t>(min_elems / n, 1000));
+    double ns = 0;
+    size_t a = 0, b = 0;
+    for (size_t r = 0; r < reps; ++r) {
+        auto input = setup();
+        allocs = alloc_bytes = 0;
+        auto t0 = chrono::steady_clock::now();
+        run(input);
+        auto t1 = chrono::steady_clock::now();
+        a += allocs;
+        b += alloc_bytes;
+        ns += chrono::duration<double, nano>(t1 - t0).count();
+    }
+    return Result{ ns / reps / n, double(a) / reps, double(b) / reps };
+}
+
+void print_header()
+{
+    printf("%-22s %-30s %-7s %10s %10s %10s %14s\n",
+           "problem", "variant", "dist", "n", "ns/elem", "allocs", "bytes");
+}
+
+void print_row(const string& problem, const string& variant, Dist d, size_t n, const Result& r)
+{
+    printf("%-22s %-30s %-7s %10zu %10.3f %10.1f %14.0f\n",
+           problem.c_str(), variant.c_str(), dist_name(d), n, r.ns_per_elem, r.allocs, r.bytes);
+    fflush(stdout);
+}
+
+// keeps results alive so the optimizer can't drop the calls
+volatile long long sink;
+
+} // namespace bench
+
+void* operator new(size_t size)
+{
+    ++bench::allocs;
+    bench::alloc_bytes += size;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+// no sized overload: the library's sized delete forwards to this one, and
+// defining it too makes GCC pair it with the library's own operator new
+void operator delete(void* p) noexcept { free(p); }
+
+#endif // __BENCH_H__
@@ -0,0 +1,184 @@
+#include "array.h"
+#include "bench.h"
+
+#include <thread>
+
+using namespace bench;
+
+// sweep every variant of the array solutions over sizes and distributions
+//   leetcode_bench [max_n] [problem]
+// max_n defaults to 1e8; hash table variants stop earlier (see limits below)
+
+// [0, n] with one value missing, sorted or shuffled
+// (inputs are distinct by definition, so there is no dups distribution)
+vector<int> missing_input(Dist d, size_t n)
+{
+    vector<int> v(n);
+    for (size_t i = 0, x = 0; i < n; ++i, ++x) {
+        if (x == n / 3) ++x;
+        v[i] = x;
+    }
+    if (d != Dist::sorted) shuffle(v.begin(), v.end(), mt19937(2));
+    return v;
+}
+
+template<class Input>
+struct Variant {
+    string name;
+    size_t max_n;                       // skip bigger inputs
+    function<void(Input&)> run;
+};
+
+const vector<Dist> all_dists = { Dist::sorted, Dist::random, Dist::dups };
+
+template<class Input>
+void sweep(const string& problem, const vector<Variant<Input>>& variants,
+           function<Input(Dist, size_t)> gen, size_t max_n,
+           const vector<Dist>& dists = all_dists)
+{
+    for (Dist d : dists) {
+        for (size_t n : sizes(max_n)) {
+            const Input input = gen(d, n);
+            for (const auto& v : variants) {
+                if (n > v.max_n) continue;
+                auto r = measure(n, [&] { return input; }, v.run);
+                print_row(problem, v.name, d, n, r);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_n = argc > 1 ? strtoull(argv[1], 0, 10) : 100000000;
+    string only = argc > 2 ? argv[2] : "";
+    const size_t all = size_t(-1);
+    const size_t hash_based = 10000000;     // hash tables of 1e8 elements don't fit
+
+    print_header();
+
+    if (only.empty() || only == "missing_number")
+        sweep<vector<int>>("missing_number", {
+            { "missingNumber1 (sort)",  all,        [](vector<int>& v) { sink = missingNumber1(v); } },
+            { "missingNumber2 (set)",   hash_based, [](vector<int>& v) { sink = missingNumber2(v); } },
+            { "missingNumber3 (xor)",   all,        [](vector<int>& v) { sink = missingNumber3(v); } },
+            { "missingNumber4 (simd xor)", all,     [](vector<int>& v) { sink = missingNumber4(v); } },
+            { "missingNumber5 (simd sum)", all,     [](vector<int>& v) { sink = missingNumber5(v); } },
+            { "missingNumberParallel",  all,        [](vector<int>& v) {
+                sink = missingNumberParallel(v, thread::hardware_concurrency()); } },
+            { "missingNumber6 (bitset)", all,       [](vector<int>& v) { sink = missingNumber6(v); } },
+            { "missingRanges (bitmap)", all,        [](vector<int>& v) {
+                sink = missingRanges(v, v.size() + 1).size(); } },
+            { "missingRanges2 (roaring)", all,      [](vector<int>& v) {
+                sink = missingRanges2(v, v.size() + 1).size(); } },
+        }, missing_input, max_n, { Dist::sorted, Dist::random });
+
+    if (only.empty() || only == "remove_element")
+        sweep<vector<int>>("remove_element", {
+            { "removeElement1 (swap)",  all, [](vector<int>& v) { sink = removeElement1(v, 3); } },
+            { "removeElement2 (2 ptr)", all, [](vector<int>& v) { sink = removeElement2(v, 3); } },
+            { "removeElement3 (simd)",  all, [](vector<int>& v) { sink = removeElement3(v, 3); } },
+            { "removeElementParallel",  all, [](vector<int>& v) {
+                sink = removeElementParallel(v, 3, thread::hardware_concurrency()); } },
+        }, [](Dist d, size_t n) { return make_values(d, n); }, max_n);
+
+    if (only.empty() || only == "remove_duplicates")
+        sweep<vector<int>>("remove_duplicates", {
+            { "removeDuplicates",       all, [](vector<int>& v) { sink = removeDuplicates(v); } },
+            { "removeDuplicates2 (simd)", all, [](vector<int>& v) { sink = removeDuplicates2(v); } },
+            { "removeDuplicatesParallel", all, [](vector<int>& v) {
+                sink = removeDuplicatesParallel(v, thread::hardware_concurrency()); } },
+        }, [](Dist d, size_t n) {
+            // input has to be sorted, the distribution sets how many repeats
+            vector<int> v = make_values(d, n);
+            sort(v.begin(), v.end());
+            return v;
+        }, max_n);
+
+    if (only.empty() || only == "reshape") {
+        // n elements as n/100 rows of 100, reshaped to rows of 50; values
+        // don't matter, so there is one distribution
+        auto jagged = [](Dist d, size_t n) {
+            vector<int> v = make_values(d, n);
+            vector<vector<int>> m(n / 100);
+            for (size_t i = 0; i < m.size(); ++i)
+                m[i].assign(v.begin() + 100 * i, v.begin() + 100 * (i + 1));
+            return m;
+        };
+        sweep<vector<vector<int>>>("reshape", {
+            { "matrixReshape (jagged)", all, [](vector<vector<int>>& m) {
+                sink = matrixReshape(m, m.size() * 2, 50).size(); } },
+            { "Matrix::fromJagged",     all, [](vector<vector<int>>& m) {
+                sink = Matrix<int>::fromJagged(m).rows(); } },
+        }, jagged, max_n, { Dist::random });
+        sweep<Matrix<int>>("reshape", {
+            { "matrixReshape2 (view)",  all, [](Matrix<int>& m) {
+                sink = matrixReshape2(m, m.rows() * 2, 50).rows(); } },
+        }, [&](Dist d, size_t n) { return Matrix<int>::fromJagged(jagged(d, n)); },
+           max_n, { Dist::random });
+    }
+
+    if (only.empty() || only == "degree")
+        sweep<vector<int>>("degree", {
+            { "findShortestSubArray",   hash_based, [](vector<int>& v) { sink = findShortestSubArray(v); } },
+            { "findShortestSubArray2 (flat)", all,  [](vector<int>& v) { sink = findShortestSubArray2(v); } },
+            { "findShortestSubArray3 (dense)", all, [](vector<int>& v) { sink = findShortestSubArray3(v); } },
+        }, [](Dist d, size_t n) { return make_values(d, n); }, max_n);
+
+    if (only.empty() || only == "merge")
+        // n elements in total: nums1 holds the first half plus room for
+        // nums2, the second half
+        sweep<pair<vector<int>, vector<int>>>("merge", {
+            { "merge (backward)",       all, [](pair<vector<int>, vector<int>>& in) {
+                int n = in.second.size(), m = in.first.size() - n;
+                merge(in.first, m, in.second, n);
+                sink = in.first[0];
+            } },
+            { "merge2 (branchless)",    all, [](pair<vector<int>, vector<int>>& in) {
+                int n = in.second.size(), m = in.first.size() - n;
+                merge2(in.first, m, in.second, n);
+                sink = in.first[0];
+            } },
+            { "merge3 (bitonic simd)",  all, [](pair<vector<int>, vector<int>>& in) {
+                int n = in.second.size(), m = in.first.size() - n;
+                merge3(in.first, m, in.second, n);
+                sink = in.first[0];
+            } },
+            { "mergeParallel",          all, [](pair<vector<int>, vector<int>>& in) {
+                int n = in.second.size(), m = in.first.size() - n;
+                mergeParallel(in.first, m, in.second, n, thread::hardware_concurrency());
+                sink = in.first[0];
+            } },
+        }, [](Dist d, size_t n) {
+            vector<int> v = make_values(d, n);
+            sort(v.begin(), v.begin() + n / 2);
+            sort(v.begin() + n / 2, v.end());
+            vector<int> nums2(v.begin() + n / 2, v.end());
+            fill(v.begin() + n / 2, v.end(), 0);
+            v.resize(n / 2 + nums2.size());
+            return make_pair(v, nums2);
+        }, max_n);
+
+    if (only.empty() || only == "merge_k")
+        // n elements split into 16 sorted runs
+        sweep<vector<vector<int>>>("merge_k", {
+            { "mergeKSorted (loser tree)", all, [](vector<vector<int>>& runs) {
+                sink = mergeKSorted(runs).size(); } },
+            { "concatenate and sort",   all, [](vector<vector<int>>& runs) {
+                vector<int> all;
+                for (const auto& r : runs) all.insert(all.end(), r.begin(), r.end());
+                sort(all.begin(), all.end());
+                sink = all.size();
+            } },
+        }, [](Dist d, size_t n) {
+            vector<int> v = make_values(d, n);
+            vector<vector<int>> runs(16);
+            for (size_t r = 0; r < 16; ++r) {
+                runs[r].assign(v.begin() + n * r / 16, v.begin() + n * (r + 1) / 16);
+                sort(runs[r].begin(), runs[r].end());
+            }
+            return runs;
+        }, max_n);
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "bench.h"
+#include "flat_hash.h"
+
+using namespace bench;
+
+// flat_hash_map / flat_hash_set against unordered_map / unordered_set on
+// the three things the solutions do with them
+//   leetcode_bench_flat_hash [max_n]
+// insert:  n keys into an empty container (map: m[k] += 1)
+// lookup:  n count() calls on a filled container, half of them misses
+// iterate: one pass over a filled container summing the elements
+
+template<class C>
+constexpr bool is_set = is_same<typename C::key_type, typename C::value_type>::value;
+
+template<class C>
+void add(C& c, int k)
+{
+    if constexpr (is_set<C>) c.insert(k);
+    else c[k] += 1;
+}
+
+template<class C>
+long long element(const typename C::value_type& v)
+{
+    if constexpr (is_set<C>) return v;
+    else return v.first + v.second;
+}
+
+template<class C>
+void rows(const string& kind, const string& name, size_t max_n)
+{
+    for (Dist d : { Dist::sorted, Dist::random, Dist::dups }) {
+        for (size_t n : sizes(max_n)) {
+            vector<int> keys = make_values(d, n);
+
+            auto r = measure(n, [] { return C(); }, [&](C& c) {
+                for (int k : keys) add(c, k);
+                sink = c.size();
+            });
+            print_row("insert (" + kind + ")", name, d, n, r);
+
+            C full;
+            for (int k : keys) add(full, k);
+            // keys are below n, so n + i is never there
+            vector<int> probes(n);
+            mt19937 gen(3);
+            for (size_t i = 0; i < n; ++i)
+                probes[i] = i % 2 ? keys[gen() % n] : int(n + i);
+
+            r = measure(n, [&] { return &full; }, [&](const C* c) {
+                size_t hits = 0;
+                for (int p : probes) hits += c->count(p);
+                sink = hits;
+            });
+            print_row("lookup (" + kind + ")", name, d, n, r);
+
+            // per element of the container, not per key inserted
+            r = measure(max<size_t>(full.size(), 1), [&] { return &full; }, [](const C* c) {
+                long long sum = 0;
+                for (const auto& v : *c) sum += element<C>(v);
+                sink = sum;
+            });
+            print_row("iterate (" + kind + ")", name, d, n, r);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_n = argc > 1 ? strtoull(argv[1], 0, 10) : 10000000;
+
+    print_header();
+    rows<unordered_map<int, int>>("map", "unordered_map<int, int>", max_n);
+    rows<flat_hash_map<int, int>>("map", "flat_hash_map<int, int>", max_n);
+    rows<unordered_set<int>>("set", "unordered_set<int>", max_n);
+    rows<flat_hash_set<int>>("set", "flat_hash_set<int>", max_n);
+    return 0;
+}
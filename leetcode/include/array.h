@@ -0,0 +1,47 @@
+#ifndef __ARRAY_H__
+#define __ARRAY_H__
+
+#include "includes.h"
+#include "matrix.h"
+
+// solutions in array/, for code outside the solution files (main, bench)
+
+// 268_missing_number.cpp
+int missingNumber1(vector<int>& nums);
+int missingNumber2(vector<int>& nums);
+int missingNumber3(vector<int>& nums);
+int missingNumber4(const vector<int>& nums);
+int missingNumber5(vector<int>& nums);
+int missingNumber6(vector<int>& nums);
+int missingNumberParallel(const vector<int>& nums, unsigned nthreads);
+vector<pair<int, int>> missingRanges(const vector<int>& ids, int universe);
+vector<pair<int, int>> missingRanges2(const vector<int>& ids, int universe);
+
+// 26_remove_duplicates_from_sorted_array.cpp
+int removeDuplicates(vector<int>& nums);
+int removeDuplicates2(vector<int>& nums);
+int removeDuplicatesParallel(vector<int>& nums, unsigned nthreads);
+
+// 27_remove_element.cpp
+int removeElement1(vector<int>& nums, int val);
+int removeElement2(vector<int>& nums, int val);
+int removeElement3(vector<int>& nums, int val);
+int removeElementParallel(vector<int>& nums, int val, unsigned nthreads);
+
+// 566_reshape_the_matrix.cpp
+vector<vector<int>> matrixReshape(vector<vector<int>>& nums, int r, int c);
+Matrix<int> matrixReshape2(Matrix<int>& nums, int r, int c);
+
+// 697_degree_of_an_array.cpp
+int findShortestSubArray(vector<int>& nums);
+int findShortestSubArray2(vector<int>& nums);
+int findShortestSubArray3(vector<int>& nums);
+
+// 88_merge_sorted_array.cpp
+void merge(vector<int>& nums1, int m, vector<int>& nums2, int n);
+void merge2(vector<int>& nums1, int m, vector<int>& nums2, int n);
+void merge3(vector<int>& nums1, int m, vector<int>& nums2, int n);
+void mergeParallel(vector<int>& nums1, int m, vector<int>& nums2, int n, unsigned nthreads);
+vector<int> mergeKSorted(const vector<vector<int>>& runs);
+
+#endif // __ARRAY_H__
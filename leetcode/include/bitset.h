@@ -0,0 +1,357 @@
+#ifndef __BITSET_H__
+#define __BITSET_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// integer sets as bits. DynamicBitset is one bit per value of a dense
+// domain [0, size()); RoaringBitmap covers all of uint32_t and stays small
+// for sparse sets by splitting values into chunks of 65536 and storing
+// each chunk either as a sorted array (few values) or as a bitmap.
+//
+// self-contained (no includes.h, everything std::-qualified) so that code
+// outside the leetcode tree can include it as well.
+
+namespace bits {
+
+#if defined(__x86_64__) || defined(__i386__)
+// popcnt is not in the x86-64 baseline: without it __builtin_popcountll
+// is a library call, so the counting loops are also built for popcnt and
+// picked at run time
+__attribute__((target("popcnt")))
+inline size_t popcountHW(const uint64_t* w, size_t n)
+{
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i) c += __builtin_popcountll(w[i]);
+    return c;
+}
+#endif
+
+inline size_t popcount(const uint64_t* w, size_t n)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool hw = __builtin_cpu_supports("popcnt");
+    if (hw) return popcountHW(w, n);
+#endif
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i) c += __builtin_popcountll(w[i]);
+    return c;
+}
+
+} // namespace bits
+
+class DynamicBitset {
+public:
+    static const size_t npos = size_t(-1);
+
+    DynamicBitset() : n(0) { }
+    explicit DynamicBitset(size_t nbits, bool value = false) : n(0) { resize(nbits, value); }
+
+    size_t size() const { return n; }
+
+    void resize(size_t nbits, bool value = false) {
+        size_t old = n;
+        w.resize((nbits + 63) / 64, value ? ~uint64_t(0) : 0);
+        n = nbits;
+        // bits of the old last word past the old size are zero
+        if (value && old < nbits && old % 64) w[old / 64] |= ~uint64_t(0) << (old % 64);
+        clearTail();
+    }
+
+    bool test(size_t i) const { return w[i / 64] >> (i % 64) & 1; }
+    void set(size_t i) { w[i / 64] |= uint64_t(1) << (i % 64); }
+    void reset(size_t i) { w[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+    void set(size_t i, bool v) { v ? set(i) : reset(i); }
+
+    void fill(bool v) {
+        std::fill(w.begin(), w.end(), v ? ~uint64_t(0) : 0);
+        clearTail();
+    }
+
+    size_t count() const { return bits::popcount(w.data(), w.size()); }
+    bool any() const {
+        for (uint64_t x : w) if (x) return true;
+        return false;
+    }
+    bool none() const { return !any(); }
+    bool all() const { return findFirstZero() == npos; }
+
+    // first set / clear bit at or after i, npos if there is none; whole
+    // words that can't hold one are skipped, the bit comes from ctz
+    size_t findNext(size_t i) const { return scan(i, 0); }
+    size_t findNextZero(size_t i) const { return scan(i, ~uint64_t(0)); }
+    size_t findFirst() const { return findNext(0); }
+    size_t findFirstZero() const { return findNextZero(0); }
+
+    // word at a time. | and ^ grow this to the other's size; & treats the
+    // bits past the other's size as clear
+    DynamicBitset& operator|=(const DynamicBitset& o) {
+        if (o.n > n) resize(o.n);
+        for (size_t i = 0; i < o.w.size(); ++i) w[i] |= o.w[i];
+        return *this;
+    }
+    DynamicBitset& operator^=(const DynamicBitset& o) {
+        if (o.n > n) resize(o.n);
+        for (size_t i = 0; i < o.w.size(); ++i) w[i] ^= o.w[i];
+        return *this;
+    }
+    DynamicBitset& operator&=(const DynamicBitset& o) {
+        size_t common = std::min(w.size(), o.w.size());
+        for (size_t i = 0; i < common; ++i) w[i] &= o.w[i];
+        std::fill(w.begin() + common, w.end(), 0);
+        return *this;
+    }
+    // clear every bit that is set in o
+    DynamicBitset& subtract(const DynamicBitset& o) {
+        size_t common = std::min(w.size(), o.w.size());
+        for (size_t i = 0; i < common; ++i) w[i] &= ~o.w[i];
+        return *this;
+    }
+
+    bool operator==(const DynamicBitset& o) const { return n == o.n && w == o.w; }
+    bool operator!=(const DynamicBitset& o) const { return !(*this == o); }
+
+    const uint64_t* words() const { return w.data(); }
+    size_t wordCount() const { return w.size(); }
+
+private:
+    // bits past n stay clear, so count() and the scans can use whole words
+    void clearTail() {
+        if (n % 64) w.back() &= ~(~uint64_t(0) << (n % 64));
+    }
+
+    // first bit at or after i that differs from the bits of flip
+    size_t scan(size_t i, uint64_t flip) const {
+        if (i >= n) return npos;
+        size_t k = i / 64;
+        uint64_t x = (w[k] ^ flip) & (~uint64_t(0) << (i % 64));
+        while (!x) {
+            if (++k == w.size()) return npos;
+            x = w[k] ^ flip;
+        }
+        size_t r = k * 64 + __builtin_ctzll(x);
+        return r < n ? r : npos;
+    }
+
+    std::vector<uint64_t> w;
+    size_t n;
+};
+
+// set of uint32_t in the style of roaring bitmaps: the high 16 bits of a
+// value pick a container, the low 16 bits are stored in it. a container
+// with up to 4096 values is a sorted array of uint16_t (2 bytes a value),
+// above that a bitmap of 65536 bits (8KB, less than 4096 array entries
+// would take). sparse sets cost about 2 bytes a value, dense ones about
+// a bit, and unions and intersections work container by container.
+class RoaringBitmap {
+public:
+    void add(uint32_t x) {
+        Container& c = containerFor(x >> 16);
+        uint16_t lo = x & 0xFFFF;
+        if (c.isBitmap()) {
+            uint64_t& word = c.bits[lo / 64], bit = uint64_t(1) << (lo % 64);
+            c.card += !(word & bit);
+            word |= bit;
+            return;
+        }
+        // values often arrive in increasing order (line numbers, ids): append
+        if (c.array.empty() || c.array.back() < lo) {
+            c.array.push_back(lo);
+        } else {
+            auto it = std::lower_bound(c.array.begin(), c.array.end(), lo);
+            if (*it == lo) return;
+            c.array.insert(it, lo);
+        }
+        ++c.card;
+        if (c.card > arrayMax) c.toBitmap();
+    }
+
+    bool remove(uint32_t x) {
+        auto ci = findContainer(x >> 16);
+        if (ci == cs.end()) return false;
+        Container& c = *ci;
+        uint16_t lo = x & 0xFFFF;
+        if (c.isBitmap()) {
+            uint64_t& word = c.bits[lo / 64], bit = uint64_t(1) << (lo % 64);
+            if (!(word & bit)) return false;
+            word &= ~bit;
+            if (--c.card <= arrayMax) c.toArray();
+        } else {
+            auto it = std::lower_bound(c.array.begin(), c.array.end(), lo);
+            if (it == c.array.end() || *it != lo) return false;
+            c.array.erase(it);
+            --c.card;
+        }
+        if (c.card == 0) cs.erase(ci);
+        return true;
+    }
+
+    bool contains(uint32_t x) const {
+        auto ci = findContainer(x >> 16);
+        return ci != cs.end() && ci->contains(x & 0xFFFF);
+    }
+
+    size_t size() const {
+        size_t s = 0;
+        for (const Container& c : cs) s += c.card;
+        return s;
+    }
+    bool empty() const { return cs.empty(); }
+
+    // f(x) for every value, ascending
+    template<class F>
+    void forEach(F f) const {
+        for (const Container& c : cs) {
+            uint32_t hi = uint32_t(c.key) << 16;
+            if (c.isBitmap()) {
+                for (size_t k = 0; k < c.bits.size(); ++k)
+                    for (uint64_t x = c.bits[k]; x; x &= x - 1)
+                        f(hi | uint32_t(k * 64 + __builtin_ctzll(x)));
+            } else {
+                for (uint16_t lo : c.array) f(hi | lo);
+            }
+        }
+    }
+
+    std::vector<uint32_t> values() const {
+        std::vector<uint32_t> out;
+        out.reserve(size());
+        forEach([&](uint32_t x) { out.push_back(x); });
+        return out;
+    }
+
+    RoaringBitmap& operator|=(const RoaringBitmap& o) {
+        std::vector<Container> out;
+        out.reserve(cs.size() + o.cs.size());
+        size_t i = 0, j = 0;
+        while (i < cs.size() || j < o.cs.size()) {
+            if (j == o.cs.size() || (i < cs.size() && cs[i].key < o.cs[j].key)) out.push_back(std::move(cs[i++]));
+            else if (i == cs.size() || o.cs[j].key < cs[i].key) out.push_back(o.cs[j++]);
+            else out.push_back(unite(cs[i++], o.cs[j++]));
+        }
+        cs.swap(out);
+        return *this;
+    }
+
+    RoaringBitmap& operator&=(const RoaringBitmap& o) {
+        std::vector<Container> out;
+        size_t i = 0, j = 0;
+        while (i < cs.size() && j < o.cs.size()) {
+            if (cs[i].key < o.cs[j].key) ++i;
+            else if (o.cs[j].key < cs[i].key) ++j;
+            else {
+                Container c = intersect(cs[i++], o.cs[j++]);
+                if (c.card) out.push_back(std::move(c));
+            }
+        }
+        cs.swap(out);
+        return *this;
+    }
+
+    bool operator==(const RoaringBitmap& o) const { return values() == o.values(); }
+
+private:
+    static const uint32_t arrayMax = 4096;
+
+    struct Container {
+        uint16_t key;
+        uint32_t card;
+        std::vector<uint16_t> array;    // sorted, while card <= arrayMax
+        std::vector<uint64_t> bits;     // 1024 words once card > arrayMax
+
+        bool isBitmap() const { return !bits.empty(); }
+
+        bool contains(uint16_t lo) const {
+            if (isBitmap()) return bits[lo / 64] >> (lo % 64) & 1;
+            return std::binary_search(array.begin(), array.end(), lo);
+        }
+
+        void toBitmap() {
+            bits.assign(1024, 0);
+            for (uint16_t lo : array) bits[lo / 64] |= uint64_t(1) << (lo % 64);
+            std::vector<uint16_t>().swap(array);
+        }
+
+        void toArray() {
+            array.clear();
+            array.reserve(card);
+            for (size_t k = 0; k < bits.size(); ++k)
+                for (uint64_t x = bits[k]; x; x &= x - 1)
+                    array.push_back(uint16_t(k * 64 + __builtin_ctzll(x)));
+            std::vector<uint64_t>().swap(bits);
+        }
+    };
+
+    std::vector<Container>::iterator findContainer(uint16_t key) {
+        auto it = std::lower_bound(cs.begin(), cs.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        return it != cs.end() && it->key == key ? it : cs.end();
+    }
+    std::vector<Container>::const_iterator findContainer(uint16_t key) const {
+        auto it = std::lower_bound(cs.begin(), cs.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        return it != cs.end() && it->key == key ? it : cs.end();
+    }
+
+    Container& containerFor(uint16_t key) {
+        if (!cs.empty() && cs.back().key == key) return cs.back();
+        auto it = std::lower_bound(cs.begin(), cs.end(), key,
+                                   [](const Container& c, uint16_t k) { return c.key < k; });
+        if (it == cs.end() || it->key != key) {
+            Container c;
+            c.key = key;
+            c.card = 0;
+            it = cs.insert(it, std::move(c));
+        }
+        return *it;
+    }
+
+    static Container unite(Container a, const Container& b) {
+        if (!a.isBitmap() && !b.isBitmap()) {
+            std::vector<uint16_t> m;
+            m.reserve(a.array.size() + b.array.size());
+            std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                           std::back_inserter(m));
+            a.array.swap(m);
+            a.card = a.array.size();
+            if (a.card > arrayMax) a.toBitmap();
+            return a;
+        }
+        if (!a.isBitmap()) a.toBitmap();
+        if (b.isBitmap())
+            for (size_t k = 0; k < 1024; ++k) a.bits[k] |= b.bits[k];
+        else
+            for (uint16_t lo : b.array) a.bits[lo / 64] |= uint64_t(1) << (lo % 64);
+        a.card = bits::popcount(a.bits.data(), a.bits.size());
+        return a;
+    }
+
+    static Container intersect(const Container& a, const Container& b) {
+        Container c;
+        c.key = a.key;
+        if (a.isBitmap() && b.isBitmap()) {
+            c.bits.resize(1024);
+            for (size_t k = 0; k < 1024; ++k) c.bits[k] = a.bits[k] & b.bits[k];
+            c.card = bits::popcount(c.bits.data(), c.bits.size());
+            if (c.card <= arrayMax) c.toArray();
+            return c;
+        }
+        if (a.isBitmap() || b.isBitmap()) {
+            const Container& arr = a.isBitmap() ? b : a;
+            const Container& bm = a.isBitmap() ? a : b;
+            for (uint16_t lo : arr.array)
+                if (bm.contains(lo)) c.array.push_back(lo);
+        } else {
+            std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                  std::back_inserter(c.array));
+        }
+        c.card = c.array.size();
+        return c;
+    }
+
+    std::vector<Container> cs;      // sorted by key, none empty
+};
+
+#endif // __BITSET_H__
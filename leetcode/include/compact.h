@@ -0,0 +1,188 @@
+#ifndef __COMPACT_H__
+#define __COMPACT_H__
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "includes.h"
+
+// stream compaction for int arrays: move the elements that pass a test to
+// the front, in order, and return how many there are. used by the
+// remove_element and remove_duplicates solutions.
+//
+// the vector kernels test 8 ints at once into an 8-bit keep mask, then
+// "left-pack" the kept lanes with one permute whose indices come from a
+// table, so there is no branch per element. they need AVX2, which is
+// checked at run time on x86; otherwise (and on other targets) a
+// branchless scalar loop does the same.
+
+#if defined(__x86_64__) || defined(__i386__)
+// leftPack[m]: indices of the set bits of m, lowest first, 3 bits each
+struct LeftPackTable {
+    uint32_t idx[256];
+    constexpr LeftPackTable() : idx() {
+        for (int m = 0; m < 256; ++m) {
+            uint32_t packed = 0;
+            for (int b = 0, k = 0; b < 8; ++b)
+                if (m >> b & 1) packed |= uint32_t(b) << (3 * k++);
+            idx[m] = packed;
+        }
+    }
+};
+
+inline constexpr LeftPackTable leftPack;
+
+// store the lanes of v selected by keep at out, packed together, and
+// return how many that is. writes all 8 lanes, the ones past the count
+// are junk the next store overwrites.
+__attribute__((target("avx2")))
+inline size_t leftPackStore(int* out, __m256i v, unsigned keep)
+{
+    const __m256i shifts = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    __m256i idx = _mm256_srlv_epi32(_mm256_set1_epi32(leftPack.idx[keep]), shifts);
+    _mm256_storeu_si256((__m256i*)out, _mm256_permutevar8x32_epi32(v, idx));
+    return __builtin_popcount(keep);
+}
+
+__attribute__((target("avx2")))
+inline unsigned equalMask(__m256i a, __m256i b)
+{
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+}
+
+// keep p[i] != val
+__attribute__((target("avx2")))
+inline size_t compactNotEqualAVX2(int* p, size_t n, int val)
+{
+    const __m256i vval = _mm256_set1_epi32(val);
+    size_t out = 0, i = 0;
+    // out <= i, so the store never reaches past the block just loaded
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        out += leftPackStore(p + out, v, ~equalMask(v, vval) & 0xff);
+    }
+    for (; i < n; ++i) {
+        p[out] = p[i];
+        out += p[i] != val;
+    }
+    return out;
+}
+#endif // x86
+
+inline size_t compactNotEqualScalar(int* p, size_t n, int val)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int x = p[i];
+        p[out] = x;             // always write, only advance on a keep
+        out += x != val;
+    }
+    return out;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// keep p[i] != p[i-1], with before standing in for p[-1]
+__attribute__((target("avx2")))
+inline size_t compactUniqueAVX2(int* p, size_t n, int before)
+{
+    const __m256i rotate = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+    size_t out = 0, i = 0;
+    int last = before;          // p[i-1] as it was before any store
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        // p[i-1 .. i+6]: v moved up one lane, last in lane 0
+        __m256i prev = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(v, rotate),
+                                          _mm256_set1_epi32(last), 1);
+        // the store may overwrite p[i+7], so take it first
+        last = p[i + 7];
+        out += leftPackStore(p + out, v, ~equalMask(v, prev) & 0xff);
+    }
+    for (; i < n; ++i) {
+        int x = p[i];
+        p[out] = x;
+        out += x != last;
+        last = x;
+    }
+    return out;
+}
+#endif // x86
+
+inline size_t compactUniqueScalar(int* p, size_t n, int before)
+{
+    size_t out = 0;
+    int last = before;
+    for (size_t i = 0; i < n; ++i) {
+        int x = p[i];
+        p[out] = x;
+        out += x != last;
+        last = x;
+    }
+    return out;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+inline bool hasAVX2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#endif // x86
+
+inline size_t compactNotEqual(int* p, size_t n, int val)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (hasAVX2()) return compactNotEqualAVX2(p, n, val);
+#endif
+    return compactNotEqualScalar(p, n, val);
+}
+
+inline size_t compactUnique(int* p, size_t n, int before)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (hasAVX2()) return compactUniqueAVX2(p, n, before);
+#endif
+    return compactUniqueScalar(p, n, before);
+}
+
+// compact(first, len, before) compacts chunks of [p, p+n) on nthreads
+// threads, in place, each into the front of its own chunk. before is the
+// element just ahead of the chunk, read before any thread starts writing
+// (p[0]^1 for the first chunk, which differs from p[0]). the kept runs are
+// then slid down one after another to the prefix sums of their lengths;
+// that pass is a memmove of the kept data, which has to go in order
+// because a run may land on the source of the one before it.
+// time: O(n / threads + kept)
+// space: O(threads)
+template<class Compact>
+size_t compactParallel(int* p, size_t n, unsigned nthreads, Compact compact)
+{
+    // below a few million ints the threads cost more than they save
+    nthreads = min<size_t>(nthreads, n / (1u << 20));
+    if (nthreads <= 1) return n ? compact(p, n, p[0] ^ 1) : 0;
+
+    vector<size_t> bound(nthreads + 1), kept(nthreads);
+    vector<int> before(nthreads);
+    for (unsigned t = 0; t <= nthreads; ++t) bound[t] = n * t / nthreads;
+    before[0] = p[0] ^ 1;
+    for (unsigned t = 1; t < nthreads; ++t) before[t] = p[bound[t] - 1];
+
+    vector<thread> pool;
+    for (unsigned t = 0; t < nthreads; ++t)
+        pool.emplace_back([&, t] {
+            kept[t] = compact(p + bound[t], bound[t + 1] - bound[t], before[t]);
+        });
+    for (auto& th : pool) th.join();
+
+    size_t out = kept[0];
+    for (unsigned t = 1; t < nthreads; ++t) {
+        memmove(p + out, p + bound[t], kept[t] * sizeof(int));
+        out += kept[t];
+    }
+    return out;
+}
+
+#endif // __COMPACT_H__
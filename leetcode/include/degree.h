@@ -0,0 +1,114 @@
+#ifndef __DEGREE_H__
+#define __DEGREE_H__
+
+#include <cstdint>
+
+#include "includes.h"
+
+// degree of an array (highest count of any value) and the shortest span
+// holding that many copies of one value, computed in one pass over a
+// stream. only first index and count are kept per distinct value: when a
+// value arrives its last index is the current one, so the span of every
+// value can be checked right as its count goes up.
+
+struct DegreeSlot {
+    int key;
+    uint32_t count;         // 0: slot is empty
+    uint64_t first;         // index of the first occurrence
+};
+
+// value -> slot by open addressing: linear probing in a power-of-two
+// table kept at most half full, fibonacci hashing for the start position
+class FlatSlotTable {
+public:
+    explicit FlatSlotTable(size_t expected = 8) : used(0) {
+        size_t cap = 16;
+        while (cap < 2 * expected) cap *= 2;
+        slots.assign(cap, DegreeSlot());
+        shift = 64 - __builtin_ctzll(cap);
+    }
+
+    // slot of key, a new one with count 0 if key wasn't there
+    DegreeSlot& find(int key) {
+        if (2 * (used + 1) > slots.size()) grow();
+        size_t mask = slots.size() - 1;
+        for (size_t i = start(key);; i = (i + 1) & mask) {
+            DegreeSlot& s = slots[i];
+            if (s.count == 0) {
+                s.key = key;
+                ++used;
+                return s;
+            }
+            if (s.key == key) return s;
+        }
+    }
+
+    size_t size() const { return used; }
+
+private:
+    size_t start(int key) const {
+        return (uint64_t(uint32_t(key)) * 0x9E3779B97F4A7C15ull) >> shift;
+    }
+
+    void grow() {
+        vector<DegreeSlot> old = move(slots);
+        slots.assign(2 * old.size(), DegreeSlot());
+        --shift;
+        size_t mask = slots.size() - 1;
+        for (const DegreeSlot& s : old) {
+            if (s.count == 0) continue;
+            size_t i = start(s.key);
+            while (slots[i].count != 0) i = (i + 1) & mask;
+            slots[i] = s;
+        }
+    }
+
+    vector<DegreeSlot> slots;
+    size_t used;
+    int shift;
+};
+
+// value -> slot for values known to lie in [lo, hi]: a plain array, no
+// hashing or probing
+class DenseSlotTable {
+public:
+    DenseSlotTable(int lo, int hi) : lo(lo), slots((size_t)((long long)hi - lo + 1)) { }
+
+    DegreeSlot& find(int key) { return slots[(long long)key - lo]; }
+
+private:
+    int lo;
+    vector<DegreeSlot> slots;
+};
+
+template<class Table>
+class DegreeTracker {
+public:
+    explicit DegreeTracker(Table t = Table()) : table(move(t)), n(0), deg(0), best(0) { }
+
+    void push(int x) {
+        DegreeSlot& s = table.find(x);
+        if (s.count++ == 0) s.first = n;
+        uint64_t span = n - s.first + 1;
+        if (s.count > deg) {
+            deg = s.count;
+            best = span;
+        } else if (s.count == deg && span < best) {
+            best = span;
+        }
+        ++n;
+    }
+
+    template<class It>
+    void push(It b, It e) { for (; b != e; ++b) push(*b); }
+
+    uint64_t size() const { return n; }             // values pushed so far
+    uint64_t degree() const { return deg; }
+    uint64_t shortest() const { return best; }      // 0 before the first push
+
+private:
+    Table table;
+    uint64_t n, deg, best;
+};
+
+#endif // __DEGREE_H__
@@ -0,0 +1,422 @@
+#ifndef __FLAT_HASH_H__
+#define __FLAT_HASH_H__
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "includes.h"
+
+// open-addressing hash map and set with the common parts of the
+// unordered_map / unordered_set interface, laid out like a Swiss table:
+// the elements sit in one flat array, and a parallel array of one-byte
+// control codes says for each slot whether it is empty, deleted, or full,
+// and if full holds 7 bits of its element's hash. a lookup compares 16
+// control bytes at once (one SSE2 compare) and only looks at elements
+// whose 7 bits match, so almost every probe touches a single element.
+//
+// nothing is allocated per element. as with any open-addressing table,
+// an insert that grows the table moves the elements, which invalidates
+// iterators, pointers and references to them.
+
+namespace flat_hash_detail {
+
+const int8_t kEmpty = -128;         // 0b10000000
+const int8_t kDeleted = -2;         // 0b11111110
+// full slots hold 0..127: the high bit alone tells full from not full
+const size_t kGroup = 16;
+
+// masks over the 16 control bytes starting at p, bit i for byte i
+struct Group {
+#ifdef __SSE2__
+    explicit Group(const int8_t* p) : v(_mm_loadu_si128((const __m128i*)p)) { }
+    unsigned match(int8_t h2) const { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(h2))); }
+    unsigned empty() const { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(kEmpty))); }
+    unsigned notFull() const { return _mm_movemask_epi8(v); }
+    __m128i v;
+#else
+    explicit Group(const int8_t* p) : p(p) { }
+    unsigned match(int8_t h2) const { return bits([=](int8_t c) { return c == h2; }); }
+    unsigned empty() const { return bits([](int8_t c) { return c == kEmpty; }); }
+    unsigned notFull() const { return bits([](int8_t c) { return c < 0; }); }
+    template<class Test> unsigned bits(Test t) const {
+        unsigned m = 0;
+        for (size_t i = 0; i < kGroup; ++i) m |= unsigned(t(p[i])) << i;
+        return m;
+    }
+    const int8_t* p;
+#endif
+    unsigned full() const { return ~notFull() & 0xFFFF; }
+};
+
+// std::hash<int> is the identity; spread it so that both the low bits
+// (group index) and the 7 control bits depend on the whole key
+inline size_t mix(size_t h)
+{
+    uint64_t x = uint64_t(h) * 0x9E3779B97F4A7C15ull;
+    return size_t(x ^ (x >> 32));
+}
+
+struct KeyIsValue {
+    template<class T> const T& operator()(const T& v) const { return v; }
+};
+
+struct KeyIsFirst {
+    template<class P> const typename P::first_type& operator()(const P& v) const { return v.first; }
+};
+
+// the table behind both flat_hash_map and flat_hash_set. Value is what is
+// stored, KeyOf gets its key. capacity is 0 or a power of two >= 16, and
+// at most 7/8 of the slots are used (full or deleted), so every probe
+// sequence runs into an empty slot and stops.
+template<class Value, class Key, class KeyOf, class Hash, class Eq>
+class Table {
+public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef size_t size_type;
+    typedef Hash hasher;
+    typedef Eq key_equal;
+
+    template<class V>
+    class Iter {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef typename remove_const<V>::type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef V* pointer;
+        typedef V& reference;
+
+        Iter() : t(0), i(0), rest(0) { }
+        // iterator converts to const_iterator
+        template<class W, class = typename enable_if<is_convertible<W*, V*>::value>::type>
+        Iter(const Iter<W>& o) : t(o.t), i(o.i), rest(o.rest) { }
+
+        V& operator*() const { return t->slots[i]; }
+        V* operator->() const { return &t->slots[i]; }
+        Iter& operator++() {
+            // next full slot of the same group straight from the mask, so
+            // stepping doesn't wait on a load of the control bytes
+            rest &= rest - 1;
+            if (rest) i = (i & ~(kGroup - 1)) + __builtin_ctz(rest);
+            else t->seek(i + 1, i, rest);
+            return *this;
+        }
+        Iter operator++(int) { Iter r = *this; ++*this; return r; }
+        bool operator==(const Iter& o) const { return i == o.i; }
+        bool operator!=(const Iter& o) const { return i != o.i; }
+
+    private:
+        friend class Table;
+        template<class> friend class Iter;
+        // on the first full slot at or after from
+        Iter(const Table* t, size_t from) : t(t) { t->seek(from, i, rest); }
+        // on slot i, known to be full (or cap for end)
+        Iter(const Table* t, size_t i, unsigned rest) : t(t), i(i), rest(rest) { }
+        const Table* t;
+        size_t i;
+        unsigned rest;      // full slots of i's group from i on, or just i
+    };
+
+    typedef Iter<Value> iterator;
+    typedef Iter<const Value> const_iterator;
+
+    Table() : ctrl(0), slots(0), cap(0), used(0), growthLeft(0) { }
+    Table(const Table& o) : Table() {
+        if (o.used == 0) return;
+        allocate(o.cap);
+        memcpy(ctrl, o.ctrl, cap);
+        forEachFull([&](size_t i) { new (slots + i) Value(o.slots[i]); });
+        used = o.used;
+        growthLeft = o.growthLeft;
+    }
+    Table(Table&& o) noexcept : Table() { swap(o); }
+    Table& operator=(Table o) { swap(o); return *this; }
+    ~Table() { destroy(); }
+
+    void swap(Table& o) noexcept {
+        std::swap(ctrl, o.ctrl);
+        std::swap(slots, o.slots);
+        std::swap(cap, o.cap);
+        std::swap(used, o.used);
+        std::swap(growthLeft, o.growthLeft);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, cap); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, cap); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return used; }
+    bool empty() const { return used == 0; }
+    size_t bucket_count() const { return cap; }
+    float load_factor() const { return cap ? float(used) / cap : 0; }
+
+    iterator find(const Key& k) { return at(findIndex(k)); }
+    const_iterator find(const Key& k) const { return const_iterator(at(findIndex(k))); }
+    size_t count(const Key& k) const { return findIndex(k) != cap; }
+    bool contains(const Key& k) const { return findIndex(k) != cap; }
+
+    size_t erase(const Key& k) {
+        size_t i = findIndex(k);
+        if (i == cap) return 0;
+        eraseAt(i);
+        return 1;
+    }
+    iterator erase(const_iterator it) {
+        eraseAt(it.i);
+        return iterator(this, it.i + 1);
+    }
+
+    void clear() {
+        forEachFull([&](size_t i) { slots[i].~Value(); });
+        if (cap) memset(ctrl, kEmpty, cap);
+        used = 0;
+        growthLeft = maxUsed(cap);
+    }
+
+    // room for n elements without growing
+    void reserve(size_t n) {
+        size_t c = kGroup;
+        while (maxUsed(c) < n) c *= 2;
+        if (c > cap) rehash(c);
+    }
+
+protected:
+    // the slot holding k, or a new one built by make(void* where) if k
+    // wasn't there; second is true for a new slot
+    template<class Make>
+    pair<iterator, bool> insertWith(const Key& k, Make make) {
+        size_t h = mix(Hash()(k));
+        size_t found = findIndex(k, h);
+        if (found != cap) return { at(found), false };
+        return { at(insertNew(h, make)), true };
+    }
+
+private:
+    // kept apart from insertWith so that the lookup in front stays small
+    // enough to inline
+    template<class Make>
+    size_t insertNew(size_t h, Make make) {
+        // k goes in the first free slot on its probe sequence
+        if (cap == 0) rehash(kGroup);
+        size_t target = findFree(h);
+        if (ctrl[target] == kEmpty) {
+            if (growthLeft == 0) {
+                // mostly tombstones: clean up in place, else double
+                rehash(used < maxUsed(cap) / 2 ? cap : 2 * cap);
+                target = findFree(h);
+            }
+            --growthLeft;
+        }
+        make((void*)(slots + target));
+        ctrl[target] = h & 0x7F;
+        ++used;
+        return target;
+    }
+
+    static size_t maxUsed(size_t c) { return c - c / 8; }
+
+    iterator at(size_t i) const { return iterator(this, i, i < cap ? 1u << (i & (kGroup - 1)) : 0); }
+
+    size_t findIndex(const Key& k) const { return findIndex(k, mix(Hash()(k))); }
+
+    // slot of k with hash h, or cap
+    size_t findIndex(const Key& k, size_t h) const {
+        if (used == 0) return cap;
+        int8_t h2 = h & 0x7F;
+        size_t gmask = cap / kGroup - 1, g = (h >> 7) & gmask;
+        // triangular steps visit every group when their number is a power of two
+        for (size_t step = 1;; ++step) {
+            Group grp(ctrl + g * kGroup);
+            for (unsigned m = grp.match(h2); m; m &= m - 1) {
+                size_t i = g * kGroup + __builtin_ctz(m);
+                if (Eq()(KeyOf()(slots[i]), k)) return i;
+            }
+            if (grp.empty()) return cap;
+            g = (g + step) & gmask;
+        }
+    }
+
+    // first empty or deleted slot on the probe sequence of hash h
+    size_t findFree(size_t h) const {
+        size_t gmask = cap / kGroup - 1, g = (h >> 7) & gmask;
+        for (size_t step = 1;; ++step) {
+            if (unsigned f = Group(ctrl + g * kGroup).notFull()) return g * kGroup + __builtin_ctz(f);
+            g = (g + step) & gmask;
+        }
+    }
+
+    // i = first full slot at or after from (cap if none), rest = the full
+    // slots of its group from i on
+    void seek(size_t from, size_t& i, unsigned& rest) const {
+        size_t g = from & ~(kGroup - 1);
+        unsigned f = from < cap ? Group(ctrl + g).full() & (0xFFFFu << (from - g)) : 0;
+        while (!f) {
+            g += kGroup;
+            if (g >= cap) {
+                i = cap;
+                rest = 0;
+                return;
+            }
+            f = Group(ctrl + g).full();
+        }
+        i = g + __builtin_ctz(f);
+        rest = f;
+    }
+
+    // f(i) for every full slot, a group of control bytes at a time: half
+    // full tables would mispredict a test per byte half the time
+    template<class F>
+    void forEachFull(F f) const {
+        for (size_t g = 0; g < cap; g += kGroup)
+            for (unsigned m = Group(ctrl + g).full(); m; m &= m - 1)
+                f(g + __builtin_ctz(m));
+    }
+
+    void eraseAt(size_t i) {
+        slots[i].~Value();
+        --used;
+        // a group with an empty slot has never been full, so no probe
+        // sequence goes past it and the slot can be plain empty again;
+        // otherwise later keys may have probed through it, keep a tombstone
+        if (Group(ctrl + (i & ~(kGroup - 1))).empty()) {
+            ctrl[i] = kEmpty;
+            ++growthLeft;
+        } else {
+            ctrl[i] = kDeleted;
+        }
+    }
+
+    void allocate(size_t c) {
+        ctrl = allocator<int8_t>().allocate(c);
+        memset(ctrl, kEmpty, c);
+        slots = allocator<Value>().allocate(c);
+        cap = c;
+        used = 0;
+        growthLeft = maxUsed(c);
+    }
+
+    void destroy() {
+        if (!cap) return;
+        forEachFull([&](size_t i) { slots[i].~Value(); });
+        allocator<Value>().deallocate(slots, cap);
+        allocator<int8_t>().deallocate(ctrl, cap);
+    }
+
+    void rehash(size_t c) {
+        Table old;
+        swap(old);
+        allocate(c);
+        old.forEachFull([&](size_t i) {
+            size_t h = mix(Hash()(KeyOf()(old.slots[i])));
+            size_t j = findFree(h);
+            new (slots + j) Value(move(old.slots[i]));
+            ctrl[j] = h & 0x7F;
+        });
+        used = old.used;
+        growthLeft -= used;
+    }
+
+    int8_t* ctrl;
+    Value* slots;
+    size_t cap;
+    size_t used;
+    size_t growthLeft;      // empty slots that may still be filled
+};
+
+} // namespace flat_hash_detail
+
+template<class K, class V, class Hash = hash<K>, class Eq = equal_to<K>>
+class flat_hash_map
+    : public flat_hash_detail::Table<pair<const K, V>, K, flat_hash_detail::KeyIsFirst, Hash, Eq> {
+    typedef flat_hash_detail::Table<pair<const K, V>, K, flat_hash_detail::KeyIsFirst, Hash, Eq> Base;
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef pair<const K, V> value_type;
+    typedef typename Base::iterator iterator;
+    typedef typename Base::const_iterator const_iterator;
+
+    flat_hash_map() { }
+    template<class It> flat_hash_map(It b, It e) { insert(b, e); }
+    flat_hash_map(initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+
+    template<class... Args>
+    pair<iterator, bool> try_emplace(const K& k, Args&&... args) {
+        return this->insertWith(k, [&](void* p) {
+            new (p) value_type(piecewise_construct, forward_as_tuple(k),
+                               forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    pair<iterator, bool> insert(const value_type& v) {
+        return this->insertWith(v.first, [&](void* p) { new (p) value_type(v); });
+    }
+    template<class... Args>
+    pair<iterator, bool> emplace(Args&&... args) { return insert(value_type(std::forward<Args>(args)...)); }
+    template<class It>
+    void insert(It b, It e) {
+        reserveFor(b, e, typename iterator_traits<It>::iterator_category());
+        for (; b != e; ++b) insert(*b);
+    }
+
+    V& operator[](const K& k) { return try_emplace(k).first->second; }
+
+    V& at(const K& k) {
+        iterator it = this->find(k);
+        if (it == this->end()) throw out_of_range("flat_hash_map::at");
+        return it->second;
+    }
+    const V& at(const K& k) const {
+        const_iterator it = this->find(k);
+        if (it == this->end()) throw out_of_range("flat_hash_map::at");
+        return it->second;
+    }
+
+private:
+    template<class It> void reserveFor(It b, It e, forward_iterator_tag) { this->reserve(this->size() + distance(b, e)); }
+    template<class It> void reserveFor(It, It, input_iterator_tag) { }
+};
+
+template<class K, class Hash = hash<K>, class Eq = equal_to<K>>
+class flat_hash_set
+    : public flat_hash_detail::Table<K, K, flat_hash_detail::KeyIsValue, Hash, Eq> {
+    typedef flat_hash_detail::Table<K, K, flat_hash_detail::KeyIsValue, Hash, Eq> Base;
+public:
+    typedef K key_type;
+    typedef K value_type;
+    typedef typename Base::iterator iterator;
+    typedef typename Base::const_iterator const_iterator;
+
+    flat_hash_set() { }
+    template<class It> flat_hash_set(It b, It e) { insert(b, e); }
+    flat_hash_set(initializer_list<K> il) { insert(il.begin(), il.end()); }
+
+    pair<iterator, bool> insert(const K& k) {
+        return this->insertWith(k, [&](void* p) { new (p) K(k); });
+    }
+    template<class... Args>
+    pair<iterator, bool> emplace(Args&&... args) { return insert(K(std::forward<Args>(args)...)); }
+    template<class It>
+    void insert(It b, It e) {
+        reserveFor(b, e, typename iterator_traits<It>::iterator_category());
+        for (; b != e; ++b) insert(*b);
+    }
+
+private:
+    template<class It> void reserveFor(It b, It e, forward_iterator_tag) { this->reserve(this->size() + distance(b, e)); }
+    template<class It> void reserveFor(It, It, input_iterator_tag) { }
+};
+
+#endif // __FLAT_HASH_H__
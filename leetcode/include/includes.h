@@ -2,6 +2,7 @@
 #define __INCLUDES_H__ 
 
 #include <vector>
+#include <algorithm>
 #include <string> 
 #include <map> 
 #include <set> 
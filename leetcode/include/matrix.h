@@ -0,0 +1,77 @@
+#ifndef __MATRIX_H__
+#define __MATRIX_H__
+
+#include <memory>
+#include <stdexcept>
+
+#include "includes.h"
+
+// dense row-major matrix: one contiguous block, element (i, j) at
+// data[i * cols + j]. the block is shared, so copying a Matrix or taking
+// reshape() of it is O(1) and both see each other's writes; clone() when
+// an independent copy is wanted.
+template<class T>
+class Matrix {
+public:
+    Matrix() : data_(make_shared<vector<T>>()), r(0), c(0) { }
+    Matrix(int rows, int cols, const T& fill = T())
+        : data_(make_shared<vector<T>>((size_t)rows * cols, fill)), r(rows), c(cols) { }
+
+    // one allocation and one pass over the elements, however many rows
+    static Matrix fromJagged(const vector<vector<T>>& rows) {
+        int cols = rows.empty() ? 0 : rows[0].size();
+        Matrix m;
+        m.data_->reserve((size_t)rows.size() * cols);
+        for (const auto& row : rows) {
+            if ((int)row.size() != cols) throw invalid_argument("rows of different lengths");
+            m.data_->insert(m.data_->end(), row.begin(), row.end());
+        }
+        m.r = rows.size();
+        m.c = cols;
+        return m;
+    }
+
+    vector<vector<T>> toJagged() const {
+        vector<vector<T>> out;
+        out.reserve(r);
+        for (int i = 0; i < r; ++i) out.emplace_back(row(i), row(i) + c);
+        return out;
+    }
+
+    int rows() const { return r; }
+    int cols() const { return c; }
+    size_t size() const { return (size_t)r * c; }
+
+    T& operator()(int i, int j) { return (*data_)[(size_t)i * c + j]; }
+    const T& operator()(int i, int j) const { return (*data_)[(size_t)i * c + j]; }
+
+    T* row(int i) { return data_->data() + (size_t)i * c; }
+    const T* row(int i) const { return data_->data() + (size_t)i * c; }
+
+    // the same elements in row-major order as rows x cols, without moving
+    // any of them; an impossible shape gives back the matrix unchanged.
+    // not const: the result shares (and can write) this matrix's elements,
+    // so reshape a clone() of a const matrix
+    Matrix reshape(int rows, int cols) {
+        if (rows < 0 || cols < 0 || (size_t)rows * cols != size()) return *this;
+        Matrix m = *this;
+        m.r = rows;
+        m.c = cols;
+        return m;
+    }
+
+    Matrix clone() const {
+        Matrix m = *this;
+        m.data_ = make_shared<vector<T>>(*data_);
+        return m;
+    }
+
+    // true if both use the same block of elements
+    bool sharesWith(const Matrix& other) const { return data_ == other.data_; }
+
+private:
+    shared_ptr<vector<T>> data_;
+    int r, c;
+};
+
+#endif // __MATRIX_H__
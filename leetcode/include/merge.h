@@ -0,0 +1,219 @@
+#ifndef __MERGE_H__
+#define __MERGE_H__
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "includes.h"
+
+// merging sorted int arrays: a branchless two-way merge, an AVX2 bitonic
+// merge kernel (x86 only, picked at run time), a merge-path split that lets threads merge independent
+// pieces, and a loser tree for k-way merges. all of them write to a
+// separate output; the scalar ones are stable (on equal keys the earlier
+// input goes first).
+
+// two pointers, but the choice between a and b is a select instead of a
+// branch, so random input costs no mispredictions
+inline void mergeBranchless(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        bool takeB = b[j] < a[i];
+        *out++ = takeB ? b[j] : a[i];
+        i += !takeB;
+        j += takeB;
+    }
+    // an empty input may be a null pointer, which memcpy must not get
+    if (i < na) memcpy(out, a + i, (na - i) * sizeof(int));
+    if (j < nb) memcpy(out + (na - i), b + j, (nb - j) * sizeof(int));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// sort a bitonic 8-lane vector: compare-exchange at distance 4, 2, 1
+__attribute__((target("avx2")))
+inline __m256i bitonicSort8(__m256i v)
+{
+    __m256i t = _mm256_permute2x128_si256(v, v, 1);
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xF0);
+    t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xCC);
+    t = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_blend_epi32(_mm256_min_epi32(v, t), _mm256_max_epi32(v, t), 0xAA);
+}
+
+// two sorted vectors in, the 8 smallest (lo) and 8 largest (hi) out, sorted
+__attribute__((target("avx2")))
+inline void bitonicMerge8(__m256i& lo, __m256i& hi)
+{
+    // a ascending followed by b descending is bitonic; one min/max splits
+    // it into two bitonic halves with every element of lo <= those of hi
+    __m256i rb = _mm256_permutevar8x32_epi32(hi, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    __m256i l = _mm256_min_epi32(lo, rb), h = _mm256_max_epi32(lo, rb);
+    lo = bitonicSort8(l);
+    hi = bitonicSort8(h);
+}
+
+// merge 8 elements at a time through a 16-element bitonic network: the
+// low half goes out, the high half stays as the carry and meets the next
+// 8 elements of whichever input has the smaller head. the network is not
+// stable, which doesn't matter for plain ints.
+__attribute__((target("avx2")))
+inline void mergeAVX2(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+    if (na < 8 || nb < 8) return mergeBranchless(a, na, b, nb, out);
+
+    __m256i lo = _mm256_loadu_si256((const __m256i*)a);
+    __m256i hi = _mm256_loadu_si256((const __m256i*)b);
+    size_t i = 8, j = 8;
+    bool fromA;
+    for (;;) {
+        bitonicMerge8(lo, hi);
+        _mm256_storeu_si256((__m256i*)out, lo);
+        out += 8;
+        fromA = j == nb || (i < na && a[i] <= b[j]);
+        if (fromA ? na - i < 8 : nb - j < 8) break;
+        lo = _mm256_loadu_si256((const __m256i*)(fromA ? a + i : b + j));
+        (fromA ? i : j) += 8;
+    }
+
+    // the side that stopped us has fewer than 8 left: merge those with the
+    // carry, then the result with the rest of the other side
+    int carry[8], small[16];
+    _mm256_storeu_si256((__m256i*)carry, hi);
+    const int* s = fromA ? a + i : b + j;
+    size_t ns = fromA ? na - i : nb - j;
+    mergeBranchless(carry, 8, s, ns, small);
+    if (fromA) mergeBranchless(small, 8 + ns, b + j, nb - j, out);
+    else mergeBranchless(a + i, na - i, small, 8 + ns, out);
+}
+#endif // x86
+
+inline void mergeSIMD(const int* a, size_t na, const int* b, size_t nb, int* out)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) return mergeAVX2(a, na, b, nb, out);
+#endif
+    mergeBranchless(a, na, b, nb, out);
+}
+
+// merge path: the first d outputs of merging a and b are a[0, i) and
+// b[0, d-i) for the i found by binary search along that diagonal
+inline size_t mergePathSplit(const int* a, size_t na, const int* b, size_t nb, size_t d)
+{
+    size_t lo = d > nb ? d - nb : 0, hi = min(d, na);
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (a[mid] <= b[d - mid - 1]) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// cut the output into nthreads equal pieces along merge-path diagonals and
+// merge each piece with mergeSIMD on its own thread; no piece depends on
+// another, so there is no fix-up afterwards
+// time: O((na + nb) / threads + threads * log(na + nb))
+inline void mergeParallel(const int* a, size_t na, const int* b, size_t nb, int* out,
+                          unsigned nthreads)
+{
+    size_t n = na + nb;
+    // below a few million ints the threads cost more than they save
+    nthreads = min<size_t>(nthreads, n / (1u << 20));
+    if (nthreads <= 1) return mergeSIMD(a, na, b, nb, out);
+
+    vector<thread> pool;
+    for (unsigned t = 0; t < nthreads; ++t)
+        pool.emplace_back([=] {
+            size_t d0 = n * t / nthreads, d1 = n * (t + 1) / nthreads;
+            size_t i0 = mergePathSplit(a, na, b, nb, d0), i1 = mergePathSplit(a, na, b, nb, d1);
+            mergeSIMD(a + i0, i1 - i0, b + (d0 - i0), (d1 - i1) - (d0 - i0), out + d0);
+        });
+    for (auto& th : pool) th.join();
+}
+
+// k-way merge with a tournament tree of losers: every internal node keeps
+// the key that lost the match played there, the overall winner sits on
+// top. taking the winner replays only the matches on its path, log2(k)
+// comparisons against losers that are already in place, with no sift
+// down like a heap's.
+//
+// a key is the run's current value in the high 32 bits and the run index
+// in the low 32, so one 64-bit compare orders by value and then by run
+// (which keeps the merge stable), and an exhausted run is a key above
+// every real one.
+class LoserTree {
+public:
+    // runs are [first, second) ranges, each sorted
+    explicit LoserTree(const vector<pair<const int*, const int*>>& runs)
+        : k(1)
+    {
+        while (k < runs.size()) k *= 2;
+        // padding runs are empty, so they lose every match
+        cur.assign(k, nullptr);
+        end.assign(k, nullptr);
+        for (size_t r = 0; r < runs.size(); ++r) {
+            cur[r] = runs[r].first;
+            end[r] = runs[r].second;
+        }
+        tree.assign(k, 0);
+        tree[0] = build(1);
+    }
+
+    bool empty() const { return tree[0] == done; }
+
+    // next element in merged order; only valid if !empty()
+    int pop() {
+        uint64_t w = tree[0];
+        size_t r = w & 0xFFFFFFFF;
+        int x = *cur[r]++;
+        w = key(r);
+        for (size_t node = (r + k) / 2; node > 0; node /= 2) {
+            // winner moves up, loser stays. select with a mask: written
+            // as min/max, compilers turn this back into a branch, which
+            // mispredicts half the time on random runs
+            uint64_t t = tree[node];
+            uint64_t m = -uint64_t(t < w);
+            uint64_t lo = (t & m) | (w & ~m);
+            tree[node] = t ^ w ^ lo;
+            w = lo;
+        }
+        tree[0] = w;
+        return x;
+    }
+
+private:
+    static const uint64_t done = ~uint64_t(0);
+
+    uint64_t key(size_t r) const {
+        if (cur[r] == end[r]) return done;
+        // flip the sign bit so signed order becomes unsigned order
+        return uint64_t(uint32_t(*cur[r]) ^ 0x80000000u) << 32 | r;
+    }
+
+    // play the matches below node, store the losers, return the winner
+    uint64_t build(size_t node) {
+        if (node >= k) return key(node - k);
+        uint64_t l = build(2 * node), r = build(2 * node + 1);
+        tree[node] = max(l, r);
+        return min(l, r);
+    }
+
+    size_t k;                       // leaves, a power of two
+    vector<const int*> cur, end;    // position and end of each run
+    vector<uint64_t> tree;          // tree[0] winner, tree[1..k) losers
+};
+
+// merge k sorted runs into out
+inline void mergeK(const vector<pair<const int*, const int*>>& runs, int* out)
+{
+    if (runs.empty()) return;
+    LoserTree t(runs);
+    while (!t.empty()) *out++ = t.pop();
+}
+
+#endif // __MERGE_H__
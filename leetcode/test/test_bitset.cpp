@@ -0,0 +1,102 @@
+#include "catch.hpp"
+#include "includes.h"
+#include "bitset.h"
+
+#include <random>
+#include <set>
+
+// RoaringBitmap against set<uint32_t> on random sequences of operations.
+// values are drawn from a few 65536-wide chunks, with most of them in a
+// narrow band, so containers fill past 4096 values (array -> bitmap) and
+// drain below it again (bitmap -> array).
+
+static uint32_t randomValue(mt19937& rng, uint32_t band)
+{
+    uint32_t chunk = rng() % 4;
+    // chunk 3 sits at the top of the range, so the high keys get used too
+    uint32_t hi = chunk == 3 ? 0xFFFF0000u : chunk << 16;
+    return hi | (rng() % band);
+}
+
+static void requireSame(const RoaringBitmap& b, const set<uint32_t>& ref)
+{
+    REQUIRE(b.size() == ref.size());
+    REQUIRE(b.empty() == ref.empty());
+    REQUIRE(b.values() == vector<uint32_t>(ref.begin(), ref.end()));
+}
+
+static void fill(mt19937& rng, RoaringBitmap& b, set<uint32_t>& ref, int n, uint32_t band)
+{
+    for (int i = 0; i < n; ++i) {
+        uint32_t x = randomValue(rng, band);
+        b.add(x);
+        ref.insert(x);
+    }
+}
+
+TEST_CASE("RoaringBitmap add, remove and contains match set", "[bitset]") {
+    mt19937 rng(11);
+    RoaringBitmap b;
+    set<uint32_t> ref;
+    // grow, then shrink, twice: each container crosses 4096 both ways
+    for (int phase = 0; phase < 4; ++phase) {
+        bool grow = phase % 2 == 0;
+        for (int op = 0; op < 40000; ++op) {
+            uint32_t x = randomValue(rng, 8192);
+            if (grow ? rng() % 4 != 0 : rng() % 4 == 0) {
+                b.add(x);
+                ref.insert(x);
+            } else {
+                REQUIRE(b.remove(x) == (ref.erase(x) == 1));
+            }
+            uint32_t y = randomValue(rng, 8192);
+            REQUIRE(b.contains(y) == (ref.count(y) == 1));
+        }
+        requireSame(b, ref);
+    }
+    for (uint32_t x : set<uint32_t>(ref)) {
+        REQUIRE(b.remove(x));
+        ref.erase(x);
+    }
+    requireSame(b, ref);
+}
+
+TEST_CASE("RoaringBitmap |= and &= match set union and intersection", "[bitset]") {
+    mt19937 rng(5);
+    for (int round = 0; round < 20; ++round) {
+        // bands from sparse to dense, so arrays meet arrays, arrays meet
+        // bitmaps and bitmaps meet bitmaps
+        const uint32_t bands[] = { 100, 5000, 20000, 65536 };
+        uint32_t ba = bands[rng() % 4], bb = bands[rng() % 4];
+        RoaringBitmap a, b;
+        set<uint32_t> ra, rb;
+        fill(rng, a, ra, rng() % 40000, ba);
+        fill(rng, b, rb, rng() % 40000, bb);
+
+        RoaringBitmap u = a;
+        u |= b;
+        set<uint32_t> ru = ra;
+        ru.insert(rb.begin(), rb.end());
+        requireSame(u, ru);
+
+        RoaringBitmap in = a;
+        in &= b;
+        set<uint32_t> ri;
+        for (uint32_t x : ra) if (rb.count(x)) ri.insert(x);
+        requireSame(in, ri);
+
+        // the results keep working as sets after the container shuffling
+        for (int op = 0; op < 2000; ++op) {
+            uint32_t x = randomValue(rng, ba);
+            REQUIRE(in.contains(x) == (ri.count(x) == 1));
+            if (rng() % 2) {
+                u.add(x);
+                ru.insert(x);
+            } else {
+                REQUIRE(u.remove(x) == (ru.erase(x) == 1));
+            }
+        }
+        requireSame(u, ru);
+        requireSame(in, ri);
+    }
+}
@@ -0,0 +1,132 @@
+#include "catch.hpp"
+#include "includes.h"
+#include "flat_hash.h"
+
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+// flat_hash_map / flat_hash_set against unordered_map / unordered_set on
+// random sequences of operations. keys come from a small range so that
+// the same keys are erased and inserted again and again, which leaves
+// tombstones behind and makes inserts reuse them or clean them up.
+
+// a hash that sends every key to one of 4 groups' worth of positions, so
+// probe sequences are long and cross many tombstones
+struct CrowdedHash {
+    size_t operator()(int k) const { return size_t(k & 3) << 4; }
+};
+
+template<class Map, class Ref>
+static void requireSameMap(const Map& m, const Ref& ref)
+{
+    REQUIRE(m.size() == ref.size());
+    size_t seen = 0;
+    for (const auto& kv : m) {
+        auto it = ref.find(kv.first);
+        REQUIRE(it != ref.end());
+        REQUIRE(it->second == kv.second);
+        ++seen;
+    }
+    REQUIRE(seen == ref.size());
+}
+
+template<class Hash>
+static void randomMapOps(unsigned seed, int keys, int ops)
+{
+    mt19937 rng(seed);
+    flat_hash_map<int, int, Hash> m;
+    unordered_map<int, int> ref;
+    for (int op = 0; op < ops; ++op) {
+        int k = rng() % keys, v = rng();
+        switch (rng() % 6) {
+        case 0: case 1: {
+            auto r = m.insert({ k, v });
+            auto e = ref.insert({ k, v });
+            REQUIRE(r.second == e.second);
+            REQUIRE(r.first->second == e.first->second);
+            break;
+        }
+        case 2:
+            m[k] = v;
+            ref[k] = v;
+            break;
+        case 3: case 4:
+            REQUIRE(m.erase(k) == ref.erase(k));
+            break;
+        case 5: {
+            auto it = m.find(k);
+            auto e = ref.find(k);
+            REQUIRE((it == m.end()) == (e == ref.end()));
+            if (e != ref.end()) REQUIRE(it->second == e->second);
+            REQUIRE(m.count(k) == ref.count(k));
+            break;
+        }
+        }
+        if (op % 1024 == 0) requireSameMap(m, ref);
+    }
+    requireSameMap(m, ref);
+}
+
+TEST_CASE("flat_hash_map matches unordered_map", "[flat_hash]") {
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        randomMapOps<hash<int>>(seed, 64, 4000);
+        randomMapOps<hash<int>>(seed, 5000, 20000);
+        randomMapOps<CrowdedHash>(seed, 200, 4000);
+    }
+}
+
+TEST_CASE("flat_hash_map erase during iteration", "[flat_hash]") {
+    mt19937 rng(7);
+    for (int round = 0; round < 50; ++round) {
+        flat_hash_map<int, int, CrowdedHash> m;
+        unordered_map<int, int> ref;
+        int n = rng() % 500;
+        for (int i = 0; i < n; ++i) {
+            int k = rng() % 1000;
+            m[k] = i;
+            ref[k] = i;
+        }
+        // drop a random part of the keys while walking the table, as
+        // with unordered_map: erase returns the next element
+        unsigned odd = rng();
+        size_t visited = 0;
+        for (auto it = m.begin(); it != m.end(); ) {
+            ++visited;
+            if ((it->first ^ odd) & 1) it = m.erase(it);
+            else ++it;
+        }
+        REQUIRE(visited == ref.size());
+        for (auto it = ref.begin(); it != ref.end(); ) {
+            if ((it->first ^ odd) & 1) it = ref.erase(it);
+            else ++it;
+        }
+        requireSameMap(m, ref);
+
+        // the tombstones left behind must not hide keys inserted later
+        for (int i = 0; i < 300; ++i) {
+            int k = rng() % 1000;
+            m[k] = -i;
+            ref[k] = -i;
+        }
+        requireSameMap(m, ref);
+    }
+}
+
+TEST_CASE("flat_hash_set matches unordered_set", "[flat_hash]") {
+    mt19937 rng(3);
+    flat_hash_set<int, CrowdedHash> s;
+    unordered_set<int> ref;
+    for (int op = 0; op < 20000; ++op) {
+        int k = rng() % 300;
+        if (rng() % 2) REQUIRE(s.insert(k).second == ref.insert(k).second);
+        else REQUIRE(s.erase(k) == ref.erase(k));
+        REQUIRE(s.contains(k) == (ref.count(k) == 1));
+    }
+    REQUIRE(s.size() == ref.size());
+    for (int k : s) REQUIRE(ref.count(k) == 1);
+
+    s.clear();
+    REQUIRE(s.empty());
+    REQUIRE(s.begin() == s.end());
+}